@@ -0,0 +1,241 @@
+/* assets.h
+ * generated by tools/assets.c from background.h, link.h, map.h and map2.h */
+
+#define background_width 88
+#define background_height 48
+#define link_width 16
+#define link_height 64
+
+#define map_width 32
+#define map_height 32
+#define map_width_shift 5
+#define map_index(tx, ty) ((((ty) & 31) << 5) | ((tx) & 31))
+
+#define map2_width 32
+#define map2_height 32
+#define map2_width_shift 5
+#define map2_index(tx, ty) ((((ty) & 31) << 5) | ((tx) & 31))
+
+#define background_banks 1
+#define link_bank 0
+#define link_swap_bank 1
+
+/* tile dedupe: 66 tiles -> 29 tiles (7 flipped), 1184 bytes saved */
+
+#define background_tiles 66
+const unsigned short background_remap [] = {
+    0x0000, 0x0001, 0x0002, 0x0003, 0x0403, 0x0004, 0x0005, 0x0000,
+    0x0006, 0x0007, 0x0000, 0x0000, 0x0008, 0x0009, 0x0803, 0x0c03,
+    0x000a, 0x000b, 0x000c, 0x000d, 0x000d, 0x000e, 0x0000, 0x000f,
+    0x0010, 0x0410, 0x040f, 0x0000, 0x0000, 0x0011, 0x0012, 0x0013,
+    0x0014, 0x000f, 0x0015, 0x0016, 0x0016, 0x0415, 0x040f, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0017, 0x0018, 0x0017,
+    0x0018, 0x0017, 0x0018, 0x0000, 0x0000, 0x0000, 0x0000, 0x0019,
+    0x001a, 0x001a, 0x001a, 0x001a, 0x001a, 0x001a, 0x001b, 0x0000,
+    0x0000, 0x001c,
+};
+
+/* background_data: 928 -> 528 bytes (lz77) */
+#define background_data_size 928
+
+const unsigned char background_data_packed [] __attribute__((aligned(4))) = {
+    0x10, 0xa0, 0x03, 0x00, 0x30, 0x11, 0x11, 0xf0, 0x01, 0x90, 0x01, 0x21,
+    0x22, 0x22, 0x22, 0x02, 0x32, 0x33, 0x33, 0x33, 0x32, 0x34, 0x00, 0x03,
+    0x33, 0x4a, 0x23, 0x00, 0x0b, 0x22, 0x44, 0x00, 0x03, 0x34, 0x30, 0x03,
+    0x43, 0x54, 0x34, 0x00, 0x1e, 0x12, 0x00, 0x1e, 0x43, 0x00, 0x02, 0x43,
+    0x22, 0xa5, 0x00, 0x04, 0x24, 0x00, 0x14, 0x23, 0x42, 0x30, 0x03, 0x22,
+    0x00, 0x03, 0x05, 0x41, 0x44, 0x44, 0x44, 0x24, 0x00, 0x24, 0x24, 0x00,
+    0x04, 0xc1, 0x20, 0x07, 0xc0, 0x03, 0x52, 0x55, 0x55, 0x55, 0x25, 0x00,
+    0x07, 0xc0, 0xf0, 0x03, 0x30, 0x03, 0x45, 0x52, 0x55, 0x25, 0x42, 0x25,
+    0x28, 0x22, 0x42, 0x60, 0x03, 0x45, 0x00, 0x03, 0x42, 0x44, 0x24, 0x0c,
+    0x42, 0x55, 0x55, 0x45, 0x10, 0x0f, 0x00, 0xa2, 0x44, 0x11, 0x00, 0x11,
+    0x41, 0x66, 0x11, 0x41, 0x64, 0x66, 0x11, 0x20, 0x64, 0x66, 0x60, 0x03,
+    0x41, 0x66, 0x76, 0x67, 0x64, 0x11, 0x66, 0x67, 0x66, 0x00, 0x1c, 0x11,
+    0x66, 0x14, 0x00, 0x03, 0x40, 0x46, 0x10, 0x03, 0x41, 0x11, 0x66, 0x66,
+    0x64, 0x14, 0x09, 0x76, 0x66, 0x66, 0x46, 0x00, 0x1a, 0x46, 0x66, 0x00,
+    0x07, 0xbc, 0x00, 0xdb, 0x23, 0x40, 0x03, 0x00, 0xdf, 0x40, 0x0b, 0x20,
+    0xeb, 0x33, 0x33, 0x81, 0x00, 0xba, 0x44, 0x42, 0x44, 0x33, 0x43, 0x42,
+    0x00, 0xd7, 0x77, 0x44, 0x00, 0x03, 0x00, 0x13, 0x40, 0x0b, 0x43, 0x00,
+    0xef, 0x00, 0x07, 0x00, 0x1f, 0xa9, 0x50, 0xa7, 0x44, 0x00, 0x03, 0x55,
+    0x00, 0x04, 0x25, 0x55, 0x10, 0x13, 0x3d, 0x55, 0x45, 0x00, 0x13, 0x00,
+    0xa6, 0x00, 0xa7, 0x40, 0xb7, 0x54, 0x00, 0x0f, 0xe7, 0x10, 0x03, 0x10,
+    0x17, 0x40, 0x03, 0x44, 0x45, 0x00, 0x1f, 0x00, 0xbb, 0x00, 0xa2, 0xaf,
+    0x00, 0xbb, 0x41, 0x00, 0xb7, 0x61, 0x00, 0xb7, 0x00, 0xbb, 0x00, 0x02,
+    0x20, 0x03, 0xe0, 0x00, 0x12, 0xf0, 0x01, 0xc0, 0x01, 0x14, 0x41, 0x11,
+    0x11, 0x14, 0x0d, 0x64, 0x14, 0x11, 0x46, 0x00, 0xe4, 0x00, 0x0d, 0x14,
+    0x00, 0xd2, 0xf9, 0x20, 0xd7, 0x40, 0x03, 0x00, 0xf9, 0xa0, 0x01, 0x00,
+    0x2d, 0x11, 0x84, 0x00, 0x06, 0x5c, 0x88, 0x00, 0x06, 0x88, 0x00, 0x06,
+    0x00, 0x07, 0x00, 0x7f, 0x44, 0x84, 0x0c, 0x88, 0x44, 0x88, 0x88, 0xf0,
+    0x01, 0x00, 0x01, 0x11, 0x64, 0x57, 0x76, 0x10, 0x9b, 0x67, 0x00, 0xa3,
+    0x76, 0x20, 0xa7, 0x20, 0xaf, 0x70, 0x01, 0xc0, 0x10, 0x83, 0x01, 0x4f,
+    0x66, 0x77, 0x67, 0x66, 0x77, 0x66, 0x1a, 0x77, 0x77, 0x77, 0x00, 0x09,
+    0x10, 0xbb, 0x46, 0x00, 0xc7, 0x14, 0xdb, 0x10, 0x2a, 0x10, 0x1b, 0x67,
+    0x10, 0x1f, 0x00, 0x06, 0x76, 0x20, 0x1e, 0x10, 0x0d, 0x11, 0x66, 0x66,
+    0x44, 0x00, 0x02, 0x11, 0x44, 0x44, 0x00, 0x3f, 0x74, 0x46, 0x10, 0x43,
+    0x00, 0xb7, 0x20, 0xaf, 0x16, 0x00, 0x06, 0x14, 0x64, 0x62, 0x46, 0x00,
+    0x3a, 0x50, 0xb9, 0x84, 0x88, 0x88, 0x00, 0xa6, 0x88, 0xf8, 0x00, 0x06,
+    0xf0, 0x01, 0xf0, 0x01, 0xf0, 0xbf, 0x32, 0x1f, 0x99, 0x11, 0x41, 0x04,
+    0x94, 0x99, 0x11, 0x94, 0x99, 0x60, 0x03, 0x41, 0x99, 0x02, 0x89, 0x98,
+    0x94, 0x99, 0x98, 0x99, 0x10, 0xcc, 0x99, 0x90, 0x00, 0x6b, 0x99, 0x49,
+    0x10, 0x03, 0x41, 0x11, 0x99, 0x99, 0x02, 0x94, 0x14, 0x89, 0x99, 0x99,
+    0x49, 0x00, 0x1a, 0x49, 0x75, 0x99, 0x00, 0x07, 0x30, 0xef, 0x00, 0x3b,
+    0x41, 0x00, 0x37, 0x91, 0x00, 0x37, 0xfe, 0x00, 0x3b, 0x00, 0x02, 0x20,
+    0x03, 0x00, 0x12, 0xf0, 0x01, 0xc0, 0x01, 0x21, 0x9f, 0x94, 0x1b, 0x14,
+    0x11, 0x49, 0x00, 0x64, 0x00, 0x0d, 0x14, 0x00, 0x52, 0x20, 0x57, 0x8c,
+    0x40, 0x03, 0x14, 0x00, 0x00, 0xf0, 0x01, 0x90, 0x01, 0x00, 0x00, 0x00,
+};
+
+/* background_palette: 32 -> 28 bytes (rle) */
+#define background_palette_size 32
+
+const unsigned char background_palette_packed [] __attribute__((aligned(4))) = {
+    0x30, 0x20, 0x00, 0x00, 0x13, 0x1f, 0x7c, 0x4b, 0x7e, 0x39, 0x05, 0x7f,
+    0x1e, 0x00, 0x00, 0xff, 0x5a, 0xff, 0x7f, 0xe7, 0x7e, 0xa0, 0x02, 0x50,
+    0x0b, 0x89, 0x00, 0x00,
+};
+
+/* link_data: 512 -> 296 bytes (huffman) */
+#define link_data_size 512
+
+const unsigned char link_data_packed [] __attribute__((aligned(4))) = {
+    0x28, 0x00, 0x02, 0x00, 0x19, 0x00, 0x00, 0x41, 0x41, 0x42, 0x02, 0x00,
+    0x02, 0x11, 0x02, 0x44, 0x02, 0x03, 0xc3, 0x84, 0xc4, 0xc5, 0xc5, 0xc6,
+    0xc6, 0x07, 0x06, 0x21, 0x54, 0x46, 0x46, 0x31, 0x64, 0x01, 0x13, 0x33,
+    0x10, 0x04, 0x40, 0x66, 0xc1, 0xc2, 0x02, 0x12, 0x55, 0x03, 0x22, 0x45,
+    0xc0, 0xc1, 0x50, 0x56, 0x20, 0x23, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff,
+    0xd2, 0x75, 0x73, 0xf2, 0x70, 0xa5, 0xeb, 0xba, 0xff, 0xff, 0xff, 0xe3,
+    0x2b, 0xc7, 0x9f, 0xff, 0xc3, 0x2b, 0x39, 0xc9, 0x49, 0x47, 0x48, 0x72,
+    0xa4, 0x84, 0x29, 0x1a, 0x22, 0x8f, 0x79, 0x98, 0x21, 0x27, 0x37, 0x9c,
+    0x70, 0x63, 0x9d, 0x1c, 0xb6, 0x30, 0xc2, 0x36, 0xca, 0xc4, 0x36, 0x31,
+    0x95, 0x56, 0xc2, 0xd8, 0xd9, 0xc6, 0x84, 0x95, 0x6e, 0x88, 0x74, 0x13,
+    0x99, 0x98, 0x84, 0x24, 0x18, 0xd3, 0x30, 0x26, 0x52, 0xe4, 0x89, 0x72,
+    0xe3, 0xd1, 0xc6, 0x14, 0xb6, 0x30, 0xa6, 0x15, 0x72, 0xc1, 0x36, 0x30,
+    0x5f, 0x59, 0x27, 0xb4, 0x8f, 0xf2, 0x1f, 0xc2, 0x87, 0xfc, 0xfc, 0xe9,
+    0xf2, 0x09, 0x1f, 0xf9, 0xf8, 0x10, 0x46, 0x7e, 0xfe, 0xfc, 0xca, 0x43,
+    0x7f, 0xfd, 0xeb, 0x57, 0xff, 0xff, 0xff, 0x9f, 0xbd, 0xfd, 0xff, 0xff,
+    0xb2, 0x2c, 0x65, 0xd9, 0xff, 0xff, 0xff, 0xcf, 0xee, 0xfd, 0xf7, 0xff,
+    0x97, 0xa5, 0x6f, 0x7b, 0xc5, 0x14, 0x2b, 0xde, 0x52, 0xc3, 0x98, 0x7a,
+    0xdd, 0x23, 0x45, 0x29, 0xb1, 0x62, 0x35, 0x7a, 0x98, 0x6f, 0xcf, 0x4d,
+    0x54, 0x11, 0x18, 0xca, 0xab, 0x60, 0xb5, 0x02, 0x01, 0x8a, 0x2a, 0xa0,
+    0xfd, 0x6e, 0xcf, 0xcd, 0x46, 0xd9, 0x6d, 0xb1, 0xba, 0x91, 0x1a, 0xdd,
+    0x25, 0xae, 0x75, 0xd7, 0x12, 0xa0, 0x4e, 0x20, 0x59, 0xeb, 0x0b, 0xaa,
+    0x90, 0x02, 0xa8, 0xaa, 0x0a, 0x40, 0xe7, 0xc0, 0xd1, 0x7f, 0x62, 0xfe,
+    0x1d, 0x9d, 0x55, 0xbd, 0x9c, 0x78, 0xef, 0x66, 0xe8, 0xcf, 0xfd, 0xf6,
+    0x59, 0xd5, 0xa3, 0xfd, 0x39, 0xfa, 0xac, 0xf4, 0x1c, 0x7d, 0xbe, 0xf4,
+    0x37, 0xfa, 0x5e, 0xfa, 0x00, 0x00, 0x00, 0x30,
+};
+
+/* link_palette: 64 -> 40 bytes (rle) */
+#define link_palette_size 64
+
+const unsigned char link_palette_packed [] __attribute__((aligned(4))) = {
+    0x30, 0x40, 0x00, 0x00, 0x0d, 0x1f, 0x7c, 0x39, 0x05, 0x50, 0x0b, 0x7f,
+    0x1e, 0x39, 0x00, 0x50, 0x03, 0x7f, 0x1a, 0x8f, 0x00, 0x0d, 0x1f, 0x7c,
+    0x21, 0x65, 0x42, 0x43, 0x67, 0x7e, 0x20, 0x64, 0x40, 0x43, 0x66, 0x7e,
+    0x8f, 0x00, 0x00, 0x00,
+};
+
+/* map: 2048 -> 140 bytes (rle) */
+#define map_size 2048
+
+const unsigned char map_packed [] __attribute__((aligned(4))) = {
+    0x30, 0x00, 0x08, 0x00, 0xff, 0x00, 0xad, 0x00, 0x02, 0x06, 0x00, 0x07,
+    0xb8, 0x00, 0x06, 0x0c, 0x00, 0x0d, 0x00, 0x0d, 0x00, 0x0e, 0x92, 0x00,
+    0x02, 0x06, 0x00, 0x07, 0x9e, 0x00, 0x06, 0x11, 0x00, 0x12, 0x00, 0x13,
+    0x00, 0x14, 0x90, 0x00, 0x06, 0x0c, 0x00, 0x0d, 0x00, 0x0d, 0x00, 0x0e,
+    0xb6, 0x00, 0x06, 0x11, 0x00, 0x12, 0x00, 0x13, 0x00, 0x14, 0xff, 0x00,
+    0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xee, 0x00, 0x0a, 0x17, 0x00, 0x18,
+    0x00, 0x17, 0x00, 0x18, 0x00, 0x17, 0x00, 0x18, 0x9a, 0x00, 0x07, 0x0f,
+    0x00, 0x10, 0x00, 0x10, 0x04, 0x0f, 0x04, 0x8b, 0x00, 0x0e, 0x19, 0x00,
+    0x1a, 0x00, 0x1a, 0x00, 0x1a, 0x00, 0x1a, 0x00, 0x1a, 0x00, 0x1a, 0x00,
+    0x1b, 0x96, 0x00, 0x0b, 0x0f, 0x00, 0x15, 0x00, 0x16, 0x00, 0x16, 0x00,
+    0x15, 0x04, 0x0f, 0x04, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00,
+    0xff, 0x00, 0xff, 0x00, 0xf5, 0x00, 0x00, 0x00,
+};
+
+/* map_linear: 2048 -> 264 bytes (rle) */
+#define map_linear_size 2048
+
+const unsigned char map_linear_packed [] __attribute__((aligned(4))) = {
+    0x30, 0x00, 0x08, 0x00, 0xff, 0x00, 0xad, 0x00, 0x02, 0x08, 0x00, 0x09,
+    0xb8, 0x00, 0x06, 0x12, 0x00, 0x14, 0x00, 0x14, 0x00, 0x15, 0x92, 0x00,
+    0x02, 0x08, 0x00, 0x09, 0x9e, 0x00, 0x06, 0x1d, 0x00, 0x1e, 0x00, 0x1f,
+    0x00, 0x20, 0x90, 0x00, 0x06, 0x12, 0x00, 0x14, 0x00, 0x14, 0x00, 0x15,
+    0xb6, 0x00, 0x06, 0x1d, 0x00, 0x1e, 0x00, 0x1f, 0x00, 0x20, 0xff, 0x00,
+    0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xee, 0x00, 0x0a, 0x2d, 0x00, 0x2e,
+    0x00, 0x2f, 0x00, 0x30, 0x00, 0x31, 0x00, 0x32, 0x9a, 0x00, 0x06, 0x17,
+    0x00, 0x18, 0x00, 0x19, 0x00, 0x1a, 0x8c, 0x00, 0x0e, 0x37, 0x00, 0x3d,
+    0x00, 0x3d, 0x00, 0x3d, 0x00, 0x3d, 0x00, 0x3d, 0x00, 0x3d, 0x00, 0x3e,
+    0x96, 0x00, 0x0a, 0x21, 0x00, 0x22, 0x00, 0x23, 0x00, 0x24, 0x00, 0x25,
+    0x00, 0x26, 0x82, 0x00, 0x7e, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34,
+    0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34,
+    0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34,
+    0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34,
+    0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34,
+    0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34,
+    0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34,
+    0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34,
+    0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34,
+    0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34,
+    0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34, 0x00, 0x34,
+    0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xf4, 0x00,
+};
+
+/* map2: 2048 -> 276 bytes (lz77) */
+#define map2_size 2048
+
+const unsigned char map2_packed [] __attribute__((aligned(4))) = {
+    0x10, 0x00, 0x08, 0x00, 0x3f, 0x1c, 0x00, 0xf0, 0x01, 0xf0, 0x01, 0xf0,
+    0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xff, 0xf0, 0x01, 0xf0, 0x01,
+    0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01,
+    0xf8, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xb0, 0x01, 0x01,
+    0x00, 0x02, 0x87, 0x60, 0x05, 0x03, 0x00, 0x03, 0x04, 0xf0, 0x21, 0xf0,
+    0x01, 0x90, 0x01, 0x10, 0x08, 0x00, 0x09, 0x60, 0x05, 0x03, 0x08, 0x03,
+    0x0c, 0xff, 0xf0, 0x21, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01,
+    0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xff, 0xf0, 0x01, 0xf0, 0x01, 0xf0,
+    0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xff,
+    0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01,
+    0xf0, 0x01, 0xf0, 0x01, 0xff, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0,
+    0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xff, 0xf0, 0x01,
+    0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01,
+    0xf0, 0x01, 0x8f, 0x90, 0x01, 0x04, 0x00, 0x05, 0xf0, 0x03, 0xf0, 0x03,
+    0xf0, 0x03, 0x40, 0x03, 0x1f, 0x0a, 0x00, 0x0b, 0xf0, 0x03, 0xf0, 0x03,
+    0xf0, 0x03, 0x40, 0x03, 0xf0, 0x91, 0xff, 0xf0, 0x01, 0xf0, 0x01, 0xf0,
+    0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xff,
+    0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01,
+    0xf0, 0x01, 0xf0, 0x01, 0xff, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0,
+    0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xff, 0xf0, 0x01,
+    0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01,
+    0xf0, 0x01, 0xff, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0,
+    0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xc0, 0xf0, 0x01, 0x90, 0x01,
+};
+
+/* map2_linear: 2048 -> 276 bytes (lz77) */
+#define map2_linear_size 2048
+
+const unsigned char map2_linear_packed [] __attribute__((aligned(4))) = {
+    0x10, 0x00, 0x08, 0x00, 0x3f, 0x41, 0x00, 0xf0, 0x01, 0xf0, 0x01, 0xf0,
+    0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xff, 0xf0, 0x01, 0xf0, 0x01,
+    0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01,
+    0xf8, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xb0, 0x01, 0x01,
+    0x00, 0x02, 0x8e, 0x60, 0x05, 0x03, 0x00, 0x04, 0xf0, 0x21, 0xf0, 0x01,
+    0xa0, 0x01, 0x0c, 0x23, 0x00, 0x0d, 0x60, 0x05, 0x0e, 0x00, 0x0f, 0xf0,
+    0x21, 0xf0, 0x01, 0xff, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01,
+    0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xff, 0xf0, 0x01, 0xf0,
+    0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0,
+    0x01, 0xff, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01,
+    0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xff, 0xf0, 0x01, 0xf0, 0x01, 0xf0,
+    0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xfe,
+    0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01,
+    0xa0, 0x01, 0x05, 0x3c, 0x00, 0x06, 0xf0, 0x03, 0xf0, 0x03, 0xf0, 0x03,
+    0x40, 0x03, 0x10, 0x00, 0x7f, 0x11, 0xf0, 0x03, 0xf0, 0x03, 0xf0, 0x03,
+    0x40, 0x03, 0xf0, 0x91, 0xf0, 0x01, 0xf0, 0x01, 0xff, 0xf0, 0x01, 0xf0,
+    0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0,
+    0x01, 0xff, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01,
+    0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xff, 0xf0, 0x01, 0xf0, 0x01, 0xf0,
+    0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xff,
+    0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01,
+    0xf0, 0x01, 0xf0, 0x01, 0xff, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0,
+    0x01, 0xf0, 0x01, 0xf0, 0x01, 0xf0, 0x01, 0x90, 0x01, 0x00, 0x00, 0x00,
+};
+
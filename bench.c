@@ -0,0 +1,285 @@
+/* host benchmarks for the per-frame game logic, build with:
+ *   gcc -DHOST -DBENCH -O2 -o bench bench.c
+ * results are written as JSON to bench_output.txt */
+#include "main.c"
+
+#include <malloc.h>
+
+#define BENCH_FRAMES 2000
+#define BENCH_OUTPUT "bench_output.txt"
+
+struct BenchResult {
+    const char* name;
+    int entities;
+    int frames;
+    unsigned long long ns;
+    int allocation_free;
+};
+
+#define MAX_BENCH_RESULTS 64
+
+struct BenchResult bench_results[MAX_BENCH_RESULTS];
+int bench_result_count = 0;
+
+unsigned long long bench_clock() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+/* heap bytes in use, the timed loops must leave this unchanged */
+size_t bench_heap() {
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+/* keys for a frame of synthetic play: walk right, turn back now and then, attack and jump */
+unsigned short bench_keys(int frame) {
+    unsigned short keys = (frame / 256) % 4 == 3 ? BUTTON_LEFT : BUTTON_RIGHT;
+    if (frame % 16 == 0) {
+        keys |= BUTTON_A;
+    }
+    if (frame % 64 == 32) {
+        keys |= BUTTON_UP;
+    }
+    return keys;
+}
+
+/* a fresh game with count entities, health maxed so nobody dies and the count stays fixed */
+void bench_populate(struct Game* game, int count) {
+    game_init(game);
+    for (int i = entity_count; i < count; i++) {
+        entity_spawn(ENTITY_ENEMY, (i * 37) % (SCREEN_WIDTH - 16), 112);
+    }
+    for (int i = 0; i < entity_count; i++) {
+        entity_health[entity_active[i]] = 255;
+    }
+}
+
+void bench_drain() {
+    transfer_flush();
+    transfer_ready = 0;
+}
+
+void bench_record(const char* name, int entities, int frames, unsigned long long ns, size_t heap) {
+    if (bench_result_count == MAX_BENCH_RESULTS) {
+        return;
+    }
+
+    struct BenchResult* result = &bench_results[bench_result_count++];
+    result->name = name;
+    result->entities = entities;
+    result->frames = frames;
+    result->ns = ns;
+    result->allocation_free = bench_heap() == heap;
+}
+
+void bench_session(int count) {
+    struct Session session;
+    session_start(&session);
+    bench_populate(&session.game, count);
+
+    size_t heap = bench_heap();
+    unsigned long long start = bench_clock();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        *buttons = ~bench_keys(frame) & BUTTON_MASK;
+        session_frame(&session);
+    }
+    bench_record("session_frame", count, BENCH_FRAMES, bench_clock() - start, heap);
+    *buttons = BUTTON_MASK;
+}
+
+void bench_game_update(int count) {
+    struct Game game;
+    bench_populate(&game, count);
+
+    size_t heap = bench_heap();
+    unsigned long long start = bench_clock();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        input_latch(bench_keys(frame));
+        game_update(&game);
+        bench_drain();
+    }
+    bench_record("game_update", count, BENCH_FRAMES, bench_clock() - start, heap);
+}
+
+void bench_physics(int count) {
+    struct Game game;
+    bench_populate(&game, count);
+
+    size_t heap = bench_heap();
+    unsigned long long start = bench_clock();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        entities_physics();
+        enemies_patrol();
+    }
+    bench_record("entities_physics", count, BENCH_FRAMES, bench_clock() - start, heap);
+}
+
+void bench_animate(int count) {
+    struct Game game;
+    bench_populate(&game, count);
+
+    size_t heap = bench_heap();
+    unsigned long long start = bench_clock();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        entities_animate();
+        bench_drain();
+    }
+    bench_record("entities_animate", count, BENCH_FRAMES, bench_clock() - start, heap);
+}
+
+/* pans across the entities so the pass keeps culling and restoring sprites */
+void bench_project(int count) {
+    struct Game game;
+    bench_populate(&game, count);
+
+    size_t heap = bench_heap();
+    unsigned long long start = bench_clock();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        entities_project(frame % (2 * SCREEN_WIDTH) - SCREEN_WIDTH);
+        sprite_update_all();
+        bench_drain();
+    }
+    bench_record("entities_project", count, BENCH_FRAMES, bench_clock() - start, heap);
+}
+
+void bench_combat(int count) {
+    unsigned int died[ENTITY_MASK_WORDS];
+    struct Game game;
+    bench_populate(&game, count);
+    for (int i = 0; i < entity_count; i++) {
+        entity_events[entity_active[i]] = ANIM_EVENT_ATTACK;
+    }
+
+    size_t heap = bench_heap();
+    unsigned long long start = bench_clock();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        collision_contacts(0);
+        combat_apply(contacts, contact_count, died);
+        for (int i = 0; i < entity_count; i++) {
+            entity_health[entity_active[i]] = 255;
+        }
+    }
+    bench_record("combat", count, BENCH_FRAMES, bench_clock() - start, heap);
+}
+
+/* keeps pure loops from being optimised away */
+volatile int bench_sink;
+
+/* count bodies dropping 8 pixels onto the foreground, the sweep is the collision kernel physics uses */
+void bench_collision_sweep(int count) {
+    size_t heap = bench_heap();
+    unsigned long long start = bench_clock();
+    int sum = 0;
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        for (int i = 0; i < count; i++) {
+            sum += collision_sweep_y((i * 37) % SCREEN_WIDTH + frame, 100, 12, 32, 8);
+        }
+    }
+    bench_record("collision_sweep", count, BENCH_FRAMES, bench_clock() - start, heap);
+    bench_sink = sum;
+}
+
+void bench_sprites(int count) {
+    struct Sprite* list[NUM_SPRITES];
+    sprite_clear();
+    for (int i = 0; i < count; i++) {
+        list[i] = sprite_init(0, 0, SIZE_16_32, 0, 0, 0, 0);
+    }
+    sprite_update_all();
+    bench_drain();
+
+    size_t heap = bench_heap();
+    unsigned long long start = bench_clock();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        for (int i = 0; i < count; i++) {
+            sprite_position(list[i], (i * 7 + frame) % SCREEN_WIDTH, (i * 13) % SCREEN_HEIGHT);
+        }
+    }
+    bench_record("sprite_position", count, BENCH_FRAMES, bench_clock() - start, heap);
+
+    heap = bench_heap();
+    start = bench_clock();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        for (int i = 0; i < count; i++) {
+            sprite_mark_dirty(list[i]);
+        }
+        sprite_update_all();
+        bench_drain();
+    }
+    bench_record("sprite_update_all", count, BENCH_FRAMES, bench_clock() - start, heap);
+
+    sprite_clear();
+}
+
+int bench_write(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        return 0;
+    }
+
+    fprintf(file, "{\n  \"frames\": %d,\n  \"results\": [\n", BENCH_FRAMES);
+    for (int i = 0; i < bench_result_count; i++) {
+        struct BenchResult* result = &bench_results[i];
+        double ns_per_frame = (double) result->ns / result->frames;
+        fprintf(file, "    {\"name\": \"%s\", \"entities\": %d, \"ns_per_frame\": %.1f, \"frames_per_second\": %.1f, \"allocation_free\": %s}%s\n",
+            result->name, result->entities, ns_per_frame, 1e9 / ns_per_frame,
+            result->allocation_free ? "true" : "false", i + 1 < bench_result_count ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+    return 1;
+}
+
+/* entity scenarios stop at MAX_ENTITIES, the sprite ones go up to all of OAM */
+const int bench_counts[] = {2, 4, 8, 16, 32, 64, 128};
+
+#define NUM_BENCH_COUNTS ((int) (sizeof(bench_counts) / sizeof(bench_counts[0])))
+
+/* --max-frame-ns N fails the run when session_frame at any entity count is slower than N */
+int main(int argc, char** argv) {
+    unsigned long long max_frame_ns = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--max-frame-ns") == 0 && i + 1 < argc) {
+            max_frame_ns = strtoull(argv[++i], 0, 10);
+        }
+    }
+
+    hal_init(argc, argv);
+    game_setup();
+
+    for (int i = 0; i < NUM_BENCH_COUNTS; i++) {
+        int count = bench_counts[i];
+        if (count <= MAX_ENTITIES) {
+            bench_session(count);
+            bench_game_update(count);
+            bench_physics(count);
+            bench_animate(count);
+            bench_project(count);
+            bench_combat(count);
+        }
+        bench_collision_sweep(count);
+        bench_sprites(count);
+    }
+
+    if (!bench_write(BENCH_OUTPUT)) {
+        fprintf(stderr, "cannot write %s\n", BENCH_OUTPUT);
+        return 1;
+    }
+
+    int failed = 0;
+    for (int i = 0; i < bench_result_count; i++) {
+        struct BenchResult* result = &bench_results[i];
+        unsigned long long ns_per_frame = result->ns / result->frames;
+        if (!result->allocation_free) {
+            fprintf(stderr, "%s with %d entities allocated memory\n", result->name, result->entities);
+            failed = 1;
+        }
+        if (max_frame_ns && strcmp(result->name, "session_frame") == 0 && ns_per_frame > max_frame_ns) {
+            fprintf(stderr, "%s with %d entities took %llu ns per frame\n", result->name, result->entities, ns_per_frame);
+            failed = 1;
+        }
+    }
+    return failed;
+}
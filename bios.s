@@ -0,0 +1,34 @@
+    .arm
+    .align 2
+
+@ BIOS decompression calls, r0 = source (with header), r1 = destination
+
+.global lz77_uncomp_wram
+    .type lz77_uncomp_wram, %function
+lz77_uncomp_wram:
+    swi 0x110000
+    bx lr
+
+.global lz77_uncomp_vram
+    .type lz77_uncomp_vram, %function
+lz77_uncomp_vram:
+    swi 0x120000
+    bx lr
+
+.global huff_uncomp
+    .type huff_uncomp, %function
+huff_uncomp:
+    swi 0x130000
+    bx lr
+
+.global rl_uncomp_wram
+    .type rl_uncomp_wram, %function
+rl_uncomp_wram:
+    swi 0x140000
+    bx lr
+
+.global rl_uncomp_vram
+    .type rl_uncomp_vram, %function
+rl_uncomp_vram:
+    swi 0x150000
+    bx lr
@@ -0,0 +1,100 @@
+    .section .iwram.text, "ax", %progbits
+    .arm
+    .align 2
+
+@ must match MAX_ENTITIES / 4 in main.c
+    .equ COMBAT_WORDS, 32
+
+@ void combat_resolve(unsigned char* health, unsigned char* pending,
+@                     const struct Contact* hits, int count, unsigned int* died)
+@ sums each hit's amount into pending, then subtracts pending from health four
+@ bytes at a time, saturating at 0, and clears pending; sets one bit in died
+@ per entity whose health dropped to 0, 32 entities to a word
+.global combat_resolve
+    .type combat_resolve, %function
+combat_resolve:
+    stmfd sp!, {r4-r11, lr}
+
+    cmp r3, #0
+    beq .Lresolve
+.Lscatter:
+    ldrb r4, [r2, #1]
+    ldrb r5, [r2, #2]
+    add r2, r2, #3
+    ldrb r6, [r1, r4]
+    add r6, r6, r5
+    cmp r6, #255
+    movgt r6, #255
+    strb r6, [r1, r4]
+    subs r3, r3, #1
+    bne .Lscatter
+
+.Lresolve:
+    @ died is the fifth argument, above the nine saved registers
+    ldr r2, [sp, #36]
+    mov r3, #COMBAT_WORDS
+    ldr r7, =0x80808080
+    ldr r8, =0x00204081
+    mov r9, #0
+    mov r10, #0
+.Lword:
+    ldr r4, [r0]
+    ldr r5, [r1]
+
+    @ r6 = per-byte x - y, no borrow between bytes
+    orr r6, r4, r7
+    bic r11, r5, r7
+    sub r6, r6, r11
+    mvn r11, r5
+    eor r11, r11, r4
+    and r11, r11, r7
+    eor r6, r6, r11
+
+    @ r11 = top bit of every byte that borrowed
+    bic r11, r5, r4
+    mvn r12, r4
+    orr r12, r12, r5
+    and r12, r12, r6
+    orr r11, r11, r12
+    and r11, r11, r7
+
+    @ clamp the borrowed bytes to 0
+    mov r12, r11, lsl #1
+    sub r12, r12, r11, lsr #7
+    bic r6, r6, r12
+
+    @ top bit of every byte that was nonzero before and is zero now
+    mvn r5, r7
+    and r11, r4, r5
+    add r11, r11, r5
+    orr r11, r11, r4
+    and r12, r6, r5
+    add r12, r12, r5
+    orr r12, r12, r6
+    bic r11, r11, r12
+    and r11, r11, r7
+
+    @ gather bits 7, 15, 23 and 31 into a nibble
+    mov r11, r11, lsr #7
+    mul r12, r11, r8
+    mov r12, r12, lsr #21
+    and r12, r12, #15
+    orr r9, r9, r12, lsl r10
+
+    str r6, [r0], #4
+    mov r12, #0
+    str r12, [r1], #4
+    add r10, r10, #4
+    cmp r10, #32
+    bne .Lnext
+    str r9, [r2], #4
+    mov r9, #0
+    mov r10, #0
+.Lnext:
+    subs r3, r3, #1
+    bne .Lword
+
+    ldmfd sp!, {r4-r11, lr}
+    bx lr
+
+    .pool
@@ -0,0 +1,70 @@
+    .section .crt0, "ax", %progbits
+    .arm
+    .align 2
+
+@ cartridge header, the logo and checksum are filled in by gbafix
+.global _start
+_start:
+    b rom_start
+    .fill 156, 1, 0
+    .fill 12, 1, 0
+    .fill 4, 1, 0
+    .fill 2, 1, 0
+    .byte 0x96
+    .byte 0
+    .byte 0
+    .fill 7, 1, 0
+    .byte 0
+    .byte 0
+    .fill 2, 1, 0
+
+rom_start:
+    mov r0, #0x12
+    msr cpsr_c, r0
+    ldr sp, =__sp_irq
+    mov r0, #0x1f
+    msr cpsr_c, r0
+    ldr sp, =__sp_usr
+
+    ldr r0, =__iwram_lma
+    ldr r1, =__iwram_start
+    ldr r2, =__iwram_end
+    bl copy_words
+    ldr r0, =__data_lma
+    ldr r1, =__data_start
+    ldr r2, =__data_end
+    bl copy_words
+    ldr r0, =__ewram_lma
+    ldr r1, =__ewram_start
+    ldr r2, =__ewram_end
+    bl copy_words
+    ldr r0, =__bss_start
+    ldr r1, =__bss_end
+    bl clear_words
+
+    mov r0, #0
+    mov r1, #0
+    ldr r3, =main
+    mov lr, pc
+    bx r3
+hang:
+    b hang
+
+@ r0 = source, r1 = destination, r2 = destination end
+copy_words:
+    cmp r1, r2
+    ldrlo r3, [r0], #4
+    strlo r3, [r1], #4
+    blo copy_words
+    bx lr
+
+@ r0 = start, r1 = end
+clear_words:
+    mov r2, #0
+.clear:
+    cmp r0, r1
+    strlo r2, [r0], #4
+    blo .clear
+    bx lr
+
+    .pool
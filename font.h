@@ -0,0 +1,72 @@
+/* font.h
+ * 3x5 glyphs for ASCII 32-95 in 8x8 cells, one byte per pixel row, bit n = column n */
+
+#define font_first 32
+#define font_count 64
+
+const unsigned char font_data [] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x04, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00,
+    0x00, 0x0a, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x0a, 0x0e, 0x0a, 0x0e, 0x0a, 0x00, 0x00,
+    0x00, 0x0c, 0x06, 0x04, 0x0c, 0x06, 0x00, 0x00,
+    0x00, 0x0a, 0x08, 0x04, 0x02, 0x0a, 0x00, 0x00,
+    0x00, 0x04, 0x0a, 0x04, 0x0a, 0x0c, 0x00, 0x00,
+    0x00, 0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x08, 0x04, 0x04, 0x04, 0x08, 0x00, 0x00,
+    0x00, 0x02, 0x04, 0x04, 0x04, 0x02, 0x00, 0x00,
+    0x00, 0x00, 0x0a, 0x04, 0x0a, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x04, 0x0e, 0x04, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x04, 0x02, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x0e, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00,
+    0x00, 0x08, 0x08, 0x04, 0x02, 0x02, 0x00, 0x00,
+    0x00, 0x0e, 0x0a, 0x0a, 0x0a, 0x0e, 0x00, 0x00,
+    0x00, 0x04, 0x06, 0x04, 0x04, 0x0e, 0x00, 0x00,
+    0x00, 0x0e, 0x08, 0x0e, 0x02, 0x0e, 0x00, 0x00,
+    0x00, 0x0e, 0x08, 0x0c, 0x08, 0x0e, 0x00, 0x00,
+    0x00, 0x0a, 0x0a, 0x0e, 0x08, 0x08, 0x00, 0x00,
+    0x00, 0x0e, 0x02, 0x0e, 0x08, 0x0e, 0x00, 0x00,
+    0x00, 0x0e, 0x02, 0x0e, 0x0a, 0x0e, 0x00, 0x00,
+    0x00, 0x0e, 0x08, 0x04, 0x04, 0x04, 0x00, 0x00,
+    0x00, 0x0e, 0x0a, 0x0e, 0x0a, 0x0e, 0x00, 0x00,
+    0x00, 0x0e, 0x0a, 0x0e, 0x08, 0x0e, 0x00, 0x00,
+    0x00, 0x00, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x04, 0x00, 0x04, 0x02, 0x00, 0x00,
+    0x00, 0x08, 0x04, 0x02, 0x04, 0x08, 0x00, 0x00,
+    0x00, 0x00, 0x0e, 0x00, 0x0e, 0x00, 0x00, 0x00,
+    0x00, 0x02, 0x04, 0x08, 0x04, 0x02, 0x00, 0x00,
+    0x00, 0x0e, 0x08, 0x0c, 0x00, 0x04, 0x00, 0x00,
+    0x00, 0x0e, 0x0a, 0x0e, 0x02, 0x0e, 0x00, 0x00,
+    0x00, 0x04, 0x0a, 0x0e, 0x0a, 0x0a, 0x00, 0x00,
+    0x00, 0x06, 0x0a, 0x06, 0x0a, 0x06, 0x00, 0x00,
+    0x00, 0x0c, 0x02, 0x02, 0x02, 0x0c, 0x00, 0x00,
+    0x00, 0x06, 0x0a, 0x0a, 0x0a, 0x06, 0x00, 0x00,
+    0x00, 0x0e, 0x02, 0x06, 0x02, 0x0e, 0x00, 0x00,
+    0x00, 0x0e, 0x02, 0x06, 0x02, 0x02, 0x00, 0x00,
+    0x00, 0x0c, 0x02, 0x0a, 0x0a, 0x0c, 0x00, 0x00,
+    0x00, 0x0a, 0x0a, 0x0e, 0x0a, 0x0a, 0x00, 0x00,
+    0x00, 0x0e, 0x04, 0x04, 0x04, 0x0e, 0x00, 0x00,
+    0x00, 0x08, 0x08, 0x08, 0x0a, 0x04, 0x00, 0x00,
+    0x00, 0x0a, 0x0a, 0x06, 0x0a, 0x0a, 0x00, 0x00,
+    0x00, 0x02, 0x02, 0x02, 0x02, 0x0e, 0x00, 0x00,
+    0x00, 0x0a, 0x0e, 0x0e, 0x0a, 0x0a, 0x00, 0x00,
+    0x00, 0x06, 0x0a, 0x0a, 0x0a, 0x0a, 0x00, 0x00,
+    0x00, 0x04, 0x0a, 0x0a, 0x0a, 0x04, 0x00, 0x00,
+    0x00, 0x06, 0x0a, 0x06, 0x02, 0x02, 0x00, 0x00,
+    0x00, 0x04, 0x0a, 0x0a, 0x06, 0x0c, 0x00, 0x00,
+    0x00, 0x06, 0x0a, 0x06, 0x0a, 0x0a, 0x00, 0x00,
+    0x00, 0x0c, 0x02, 0x04, 0x08, 0x06, 0x00, 0x00,
+    0x00, 0x0e, 0x04, 0x04, 0x04, 0x04, 0x00, 0x00,
+    0x00, 0x0a, 0x0a, 0x0a, 0x0a, 0x0e, 0x00, 0x00,
+    0x00, 0x0a, 0x0a, 0x0a, 0x0a, 0x04, 0x00, 0x00,
+    0x00, 0x0a, 0x0a, 0x0e, 0x0e, 0x0a, 0x00, 0x00,
+    0x00, 0x0a, 0x0a, 0x04, 0x0a, 0x0a, 0x00, 0x00,
+    0x00, 0x0a, 0x0a, 0x04, 0x04, 0x04, 0x00, 0x00,
+    0x00, 0x0e, 0x08, 0x04, 0x02, 0x0e, 0x00, 0x00,
+    0x00, 0x0c, 0x04, 0x04, 0x04, 0x0c, 0x00, 0x00,
+    0x00, 0x02, 0x02, 0x04, 0x08, 0x08, 0x00, 0x00,
+    0x00, 0x06, 0x04, 0x04, 0x04, 0x06, 0x00, 0x00,
+    0x00, 0x04, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x0e, 0x00, 0x00,
+};
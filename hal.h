@@ -0,0 +1,403 @@
+/* hal.h
+ * memory map and hardware primitives, for the GBA or a headless host build (-DHOST) */
+
+#ifdef HOST
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+unsigned char host_io[0x400] __attribute__((aligned(4)));
+unsigned char host_palette[0x400] __attribute__((aligned(4)));
+unsigned char host_vram[0x18000] __attribute__((aligned(4)));
+unsigned char host_oam[0x400] __attribute__((aligned(4)));
+unsigned char host_bios_irq[4] __attribute__((aligned(4)));
+/* the GBA handler slot is 4 bytes past the flags, too narrow for a host pointer */
+void (*host_bios_handler)(void);
+unsigned char host_sram[0x8000];
+
+#define IO_BASE host_io
+#define PALETTE_BASE host_palette
+#define VRAM_BASE host_vram
+#define OAM_BASE host_oam
+#define BIOS_IRQ_BASE host_bios_irq
+#define BIOS_IRQ_HANDLER ((unsigned char*) &host_bios_handler)
+#define SRAM_BASE host_sram
+
+#define IWRAM_DATA
+#define IWRAM_CODE
+#define EWRAM_DATA
+
+#else
+
+#define IO_BASE ((unsigned char*) 0x4000000)
+#define PALETTE_BASE ((unsigned char*) 0x5000000)
+#define VRAM_BASE ((unsigned char*) 0x6000000)
+#define OAM_BASE ((unsigned char*) 0x7000000)
+#define BIOS_IRQ_BASE ((unsigned char*) 0x3007ff8)
+#define BIOS_IRQ_HANDLER (BIOS_IRQ_BASE + 4)
+#define SRAM_BASE ((unsigned char*) 0xe000000)
+
+/* see gba.ld: IWRAM code is built as ARM and reached with long calls from ROM */
+#define IWRAM_DATA __attribute__((section(".iwram")))
+#define IWRAM_CODE __attribute__((section(".iwram.text"), target("arm"), long_call, noinline))
+#define EWRAM_DATA __attribute__((section(".ewram")))
+
+#endif
+
+typedef void (*irq_handler)(void);
+
+volatile unsigned int* display_control = (volatile unsigned int*) (IO_BASE + 0x000);
+volatile unsigned short* display_status = (volatile unsigned short*) (IO_BASE + 0x004);
+volatile unsigned short* scanline_counter = (volatile unsigned short*) (IO_BASE + 0x006);
+
+volatile unsigned short* bg0_control = (volatile unsigned short*) (IO_BASE + 0x008);
+volatile unsigned short* bg1_control = (volatile unsigned short*) (IO_BASE + 0x00a);
+volatile unsigned short* bg2_control = (volatile unsigned short*) (IO_BASE + 0x00c);
+volatile unsigned short* bg3_control = (volatile unsigned short*) (IO_BASE + 0x00e);
+
+volatile short* bg0_x_scroll = (volatile short*) (IO_BASE + 0x010);
+volatile short* bg0_y_scroll = (volatile short*) (IO_BASE + 0x012);
+volatile short* bg1_x_scroll = (volatile short*) (IO_BASE + 0x014);
+volatile short* bg1_y_scroll = (volatile short*) (IO_BASE + 0x016);
+volatile short* bg2_x_scroll = (volatile short*) (IO_BASE + 0x018);
+volatile short* bg2_y_scroll = (volatile short*) (IO_BASE + 0x01a);
+volatile short* bg3_x_scroll = (volatile short*) (IO_BASE + 0x01c);
+volatile short* bg3_y_scroll = (volatile short*) (IO_BASE + 0x01e);
+
+volatile unsigned short* mosaic = (volatile unsigned short*) (IO_BASE + 0x04c);
+volatile unsigned short* blend_control = (volatile unsigned short*) (IO_BASE + 0x050);
+volatile unsigned short* blend_alpha = (volatile unsigned short*) (IO_BASE + 0x052);
+volatile unsigned short* blend_brightness = (volatile unsigned short*) (IO_BASE + 0x054);
+
+volatile unsigned int* dma0_source = (volatile unsigned int*) (IO_BASE + 0x0b0);
+volatile unsigned int* dma0_destination = (volatile unsigned int*) (IO_BASE + 0x0b4);
+volatile unsigned int* dma0_count = (volatile unsigned int*) (IO_BASE + 0x0b8);
+
+volatile unsigned int* dma_source = (volatile unsigned int*) (IO_BASE + 0x0d4);
+volatile unsigned int* dma_destination = (volatile unsigned int*) (IO_BASE + 0x0d8);
+volatile unsigned int* dma_count = (volatile unsigned int*) (IO_BASE + 0x0dc);
+
+volatile unsigned short* timer2_data = (volatile unsigned short*) (IO_BASE + 0x108);
+volatile unsigned short* timer2_control = (volatile unsigned short*) (IO_BASE + 0x10a);
+volatile unsigned short* timer3_data = (volatile unsigned short*) (IO_BASE + 0x10c);
+volatile unsigned short* timer3_control = (volatile unsigned short*) (IO_BASE + 0x10e);
+
+volatile unsigned short* buttons = (volatile unsigned short*) (IO_BASE + 0x130);
+
+volatile unsigned short* interrupt_enable = (volatile unsigned short*) (IO_BASE + 0x200);
+volatile unsigned short* interrupt_flags = (volatile unsigned short*) (IO_BASE + 0x202);
+volatile unsigned short* interrupt_master = (volatile unsigned short*) (IO_BASE + 0x208);
+
+volatile unsigned short* bios_interrupt_flags = (volatile unsigned short*) (BIOS_IRQ_BASE + 0);
+volatile irq_handler* bios_interrupt_handler = (volatile irq_handler*) BIOS_IRQ_HANDLER;
+
+volatile unsigned short* bg_palette = (volatile unsigned short*) (PALETTE_BASE + 0x000);
+volatile unsigned short* sprite_palette = (volatile unsigned short*) (PALETTE_BASE + 0x200);
+
+volatile unsigned short* sprite_image_memory = (volatile unsigned short*) (VRAM_BASE + 0x10000);
+
+volatile unsigned short* sprite_attribute_memory = (volatile unsigned short*) OAM_BASE;
+
+/* 8-bit bus, only byte accesses work */
+volatile unsigned char* sram = (volatile unsigned char*) SRAM_BASE;
+
+#define SRAM_SIZE 0x8000
+
+volatile unsigned short* char_block(unsigned long block) {
+    return (volatile unsigned short*) (VRAM_BASE + (block * 0x4000));
+}
+
+volatile unsigned short* screen_block(unsigned long block) {
+    return (volatile unsigned short*) (VRAM_BASE + (block * 0x800));
+}
+
+#define DMA_ENABLE 0x80000000
+
+#define DMA_16 0x00000000
+#define DMA_32 0x04000000
+
+#define DMA_DEST_FIXED 0x00400000
+#define DMA_DEST_RELOAD 0x00600000
+#define DMA_REPEAT 0x02000000
+#define DMA_HBLANK 0x20000000
+
+#define TIMER_ENABLE 0x80
+#define TIMER_CASCADE 0x04
+
+/* main.c owns the table, irq_dispatch walks it */
+extern irq_handler irq_handlers[];
+
+#ifdef HOST
+
+#define HOST_DEFAULT_FRAMES 600
+
+unsigned int host_vblanks = 0;
+unsigned int host_frame_limit = HOST_DEFAULT_FRAMES;
+
+/* keys held at power-on, released after the first VBlank */
+unsigned short host_boot_keys = 0x3ff;
+const char* host_sram_path = 0;
+int host_asset_report = 0;
+
+void memcpy16_dma(unsigned short* dest, unsigned short* source, int amount) {
+    memcpy(dest, source, amount * 2);
+}
+
+void memcpy32_dma(unsigned int* dest, unsigned int* source, int amount) {
+    memcpy(dest, source, amount * 4);
+}
+
+/* there are no scanlines on the host, the register keeps the value set at VBlank */
+void dma0_hblank(volatile unsigned short* dest, const unsigned short* source) {
+    (void) dest;
+    (void) source;
+}
+
+void dma0_stop() {
+}
+
+void irq_dispatch(void) {
+    unsigned short fired = *interrupt_enable & *interrupt_flags;
+    *interrupt_flags &= ~fired;
+    *bios_interrupt_flags |= fired;
+
+    for (int i = 0; fired; i++, fired >>= 1) {
+        if ((fired & 1) && irq_handlers[i]) {
+            irq_handlers[i]();
+        }
+    }
+}
+
+/* there is no display to wait on, so each call is one emulated VBlank */
+void vblank_intr_wait(void) {
+    if (host_vblanks++ == 0) {
+        *buttons = 0x3ff;
+    }
+    *scanline_counter = 160;
+    *interrupt_flags = 1;
+    if (*interrupt_master) {
+        irq_dispatch();
+    }
+    *scanline_counter = 0;
+}
+
+unsigned int read32(const unsigned char* bytes) {
+    return bytes[0] | ((unsigned int) bytes[1] << 8) | ((unsigned int) bytes[2] << 16) | ((unsigned int) bytes[3] << 24);
+}
+
+/* C versions of the BIOS decompression calls */
+void lz77_uncomp_wram(const void* source, void* dest) {
+    const unsigned char* in = (const unsigned char*) source;
+    unsigned char* out = (unsigned char*) dest;
+    int size = read32(in) >> 8;
+    int written = 0;
+    in += 4;
+
+    while (written < size) {
+        unsigned char flags = *in++;
+        for (int bit = 7; bit >= 0 && written < size; bit--) {
+            if (flags & (1 << bit)) {
+                int length = (in[0] >> 4) + 3;
+                int disp = (((in[0] & 0xf) << 8) | in[1]) + 1;
+                in += 2;
+                for (int i = 0; i < length && written < size; i++, written++) {
+                    out[written] = out[written - disp];
+                }
+            } else {
+                out[written++] = *in++;
+            }
+        }
+    }
+}
+
+void lz77_uncomp_vram(const void* source, void* dest) {
+    lz77_uncomp_wram(source, dest);
+}
+
+void huff_uncomp(const void* source, void* dest) {
+    const unsigned char* in = (const unsigned char*) source;
+    unsigned int* out = (unsigned int*) dest;
+    int bits = in[0] & 0xf;
+    int size = read32(in) >> 8;
+    const unsigned char* tree = in + 4;
+    const unsigned char* stream = tree + (tree[0] + 1) * 2;
+
+    unsigned int word = 0;
+    int filled = 0, written = 0, node = 1;
+    while (written < size) {
+        unsigned int code = read32(stream);
+        stream += 4;
+        for (int b = 31; b >= 0 && written < size; b--) {
+            int side = (code >> b) & 1;
+            int child = (node & ~1) + (tree[node] & 0x3f) * 2 + 2 + side;
+            if (tree[node] & (side ? 0x40 : 0x80)) {
+                word |= tree[child] << filled;
+                filled += bits;
+                if (filled == 32) {
+                    *out++ = word;
+                    written += 4;
+                    word = 0;
+                    filled = 0;
+                }
+                node = 1;
+            } else {
+                node = child;
+            }
+        }
+    }
+}
+
+void rl_uncomp_wram(const void* source, void* dest) {
+    const unsigned char* in = (const unsigned char*) source;
+    unsigned char* out = (unsigned char*) dest;
+    int size = read32(in) >> 8;
+    int written = 0;
+    in += 4;
+
+    while (written < size) {
+        unsigned char flag = *in++;
+        if (flag & 0x80) {
+            int length = (flag & 0x7f) + 3;
+            for (int i = 0; i < length; i++) {
+                out[written++] = *in;
+            }
+            in++;
+        } else {
+            int length = (flag & 0x7f) + 1;
+            for (int i = 0; i < length; i++) {
+                out[written++] = *in++;
+            }
+        }
+    }
+}
+
+void rl_uncomp_vram(const void* source, void* dest) {
+    rl_uncomp_wram(source, dest);
+}
+
+int hal_is_vram(const void* address) {
+    const unsigned char* p = (const unsigned char*) address;
+    return (p >= host_palette && p < host_palette + sizeof(host_palette)) ||
+        (p >= host_vram && p < host_vram + sizeof(host_vram)) ||
+        (p >= host_oam && p < host_oam + sizeof(host_oam));
+}
+
+/* nanoseconds on the host */
+unsigned int hal_clock() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000u + now.tv_nsec;
+}
+
+void hal_init(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            host_frame_limit = strtoul(argv[++i], 0, 10);
+        } else if (strcmp(argv[i], "--sram") == 0 && i + 1 < argc) {
+            host_sram_path = argv[++i];
+        } else if (strcmp(argv[i], "--record") == 0) {
+            host_boot_keys &= ~(1 << 9);
+        } else if (strcmp(argv[i], "--replay") == 0) {
+            host_boot_keys &= ~(1 << 8);
+        } else if (strcmp(argv[i], "--asset-report") == 0) {
+            host_asset_report = 1;
+        }
+    }
+
+    memset(host_sram, 0xff, sizeof(host_sram));
+    if (host_sram_path) {
+        FILE* file = fopen(host_sram_path, "rb");
+        if (file) {
+            fread(host_sram, 1, sizeof(host_sram), file);
+            fclose(file);
+        }
+    }
+
+    *buttons = host_boot_keys;
+}
+
+void hal_shutdown() {
+    if (host_sram_path) {
+        FILE* file = fopen(host_sram_path, "wb");
+        if (file) {
+            fwrite(host_sram, 1, sizeof(host_sram), file);
+            fclose(file);
+        }
+    }
+}
+
+int hal_running() {
+    return host_vblanks < host_frame_limit;
+}
+
+#else
+
+void memcpy16_dma(unsigned short* dest, unsigned short* source, int amount) {
+    *dma_source = (unsigned int) source;
+    *dma_destination = (unsigned int) dest;
+    *dma_count = amount | DMA_16 | DMA_ENABLE;
+}
+
+void memcpy32_dma(unsigned int* dest, unsigned int* source, int amount) {
+    *dma_source = (unsigned int) source;
+    *dma_destination = (unsigned int) dest;
+    *dma_count = amount | DMA_32 | DMA_ENABLE;
+}
+
+/* copies one halfword from source to dest every HBlank, stepping through source */
+void dma0_hblank(volatile unsigned short* dest, const unsigned short* source) {
+    *dma0_source = (unsigned int) source;
+    *dma0_destination = (unsigned int) dest;
+    *dma0_count = 1 | DMA_16 | DMA_DEST_RELOAD | DMA_REPEAT | DMA_HBLANK | DMA_ENABLE;
+}
+
+void dma0_stop() {
+    *dma0_count = 0;
+}
+
+/* irq.s */
+void irq_dispatch(void);
+void vblank_intr_wait(void);
+
+/* bios.s */
+void lz77_uncomp_wram(const void* source, void* dest);
+void lz77_uncomp_vram(const void* source, void* dest);
+void huff_uncomp(const void* source, void* dest);
+void rl_uncomp_wram(const void* source, void* dest);
+void rl_uncomp_vram(const void* source, void* dest);
+
+/* palette, VRAM and OAM sit on a 16-bit bus that drops byte writes */
+int hal_is_vram(const void* address) {
+    unsigned int a = (unsigned int) address;
+    return a >= 0x5000000 && a < 0x8000000;
+}
+
+/* CPU cycles, from TM2 cascading into TM3 */
+unsigned int hal_clock() {
+    unsigned short high, low;
+    do {
+        high = *timer3_data;
+        low = *timer2_data;
+    } while (high != *timer3_data);
+    return (high << 16) | low;
+}
+
+void hal_init(int argc, char** argv) {
+    *timer2_control = 0;
+    *timer3_control = 0;
+    *timer2_data = 0;
+    *timer3_data = 0;
+    *timer3_control = TIMER_ENABLE | TIMER_CASCADE;
+    *timer2_control = TIMER_ENABLE;
+}
+
+int hal_running() {
+    return 1;
+}
+
+void hal_shutdown() {
+}
+
+#endif
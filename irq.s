@@ -0,0 +1,48 @@
+    .section .iwram.text, "ax", %progbits
+    .arm
+    .align 2
+
+@ installed at the BIOS handler slot, entered in ARM mode with IRQs off
+.global irq_dispatch
+    .type irq_dispatch, %function
+irq_dispatch:
+    mov r3, #0x4000000
+    ldr r2, [r3, #0x200]!
+    and r2, r2, r2, lsr #16
+    strh r2, [r3, #2]
+    ldr r1, =0x3007ff8
+    ldrh r0, [r1]
+    orr r0, r0, r2
+    strh r0, [r1]
+    stmfd sp!, {r4, r5, r6, lr}
+    mov r4, r2
+    ldr r5, =irq_handlers
+.next:
+    cmp r4, #0
+    beq .done
+    tst r4, #1
+    beq .skip
+    ldr r0, [r5]
+    cmp r0, #0
+    beq .skip
+    mov lr, pc
+    bx r0
+.skip:
+    mov r4, r4, lsr #1
+    add r5, r5, #4
+    b .next
+.done:
+    ldmfd sp!, {r4, r5, r6, lr}
+    bx lr
+
+    .pool
+
+    .text
+    .arm
+    .align 2
+
+.global vblank_intr_wait
+    .type vblank_intr_wait, %function
+vblank_intr_wait:
+    swi 0x050000
+    bx lr
@@ -1,45 +1,31 @@
 #define SCREEN_WIDTH 240
 #define SCREEN_HEIGHT 160
 
-#include "background.h"
-#include "link.h"
-#include "map.h"
-#include "map2.h"
+#include "hal.h"
+
+#include "assets.h"
+#include "font.h"
 
 #define MODE0 0x00
 #define BG0_ENABLE 0x100
 #define BG1_ENABLE 0x200
+#define BG2_ENABLE 0x400
+#define BG3_ENABLE 0x800
 
 #define SPRITE_MAP_2D 0x0
 #define SPRITE_MAP_1D 0x40
 #define SPRITE_ENABLE 0x1000
 
-volatile unsigned short* bg0_control = (volatile unsigned short*) 0x4000008;
-volatile unsigned short* bg1_control = (volatile unsigned short*) 0x400000a;
-
 #define PALETTE_SIZE 256
 
 #define NUM_SPRITES 128
 
-volatile unsigned long* display_control = (volatile unsigned long*) 0x4000000;
-
-volatile unsigned short* sprite_attribute_memory = (volatile unsigned short*) 0x7000000;
-
-volatile unsigned short* sprite_image_memory = (volatile unsigned short*) 0x6010000;
-
-volatile unsigned short* bg_palette = (volatile unsigned short*) 0x5000000;
-volatile unsigned short* sprite_palette = (volatile unsigned short*) 0x5000200;
-
-volatile unsigned short* buttons = (volatile unsigned short*) 0x04000130;
-
-volatile short* bg0_x_scroll = (unsigned short*) 0x4000010;
-volatile short* bg0_y_scroll = (unsigned short*) 0x4000012;
-volatile short* bg1_x_scroll = (unsigned short*) 0x4000014;
-volatile short* bg1_y_scroll = (unsigned short*) 0x4000016;
+/* each entity owns one 256 byte image slot in OBJ VRAM, 128 of them fill it */
+#define MAX_ENTITIES 128
 
 #define BUTTON_A (1 << 0)
 #define BUTTON_B (1 << 1)
-#define BUTTON_SELECT (1 < 2)
+#define BUTTON_SELECT (1 << 2)
 #define BUTTON_START (1 << 3)
 #define BUTTON_RIGHT (1 << 4)
 #define BUTTON_LEFT (1 << 5)
@@ -47,76 +33,824 @@ volatile short* bg1_y_scroll = (unsigned short*) 0x4000016;
 #define BUTTON_DOWN (1 << 7)
 #define BUTTON_R (1 << 8)
 #define BUTTON_L (1 << 9)
+#define BUTTON_MASK 0x3ff
+
+#define DISPSTAT_VBLANK_IRQ 0x0008
+#define DISPSTAT_HBLANK_IRQ 0x0010
+#define DISPSTAT_VCOUNT_IRQ 0x0020
+
+enum Interrupt {
+    IRQ_VBLANK,
+    IRQ_HBLANK,
+    IRQ_VCOUNT,
+    IRQ_TIMER0,
+    IRQ_TIMER1,
+    IRQ_TIMER2,
+    IRQ_TIMER3,
+    IRQ_SERIAL,
+    IRQ_DMA0,
+    IRQ_DMA1,
+    IRQ_DMA2,
+    IRQ_DMA3,
+    IRQ_KEYPAD,
+    IRQ_GAMEPAK,
+    NUM_IRQS
+};
 
-volatile unsigned short* scanline_counter = (volatile unsigned short*) 0x4000006;
+/* read by irq_dispatch in irq.s, one slot per IE bit */
+irq_handler irq_handlers[NUM_IRQS];
 
-void wait_vblank() {
-    while (*scanline_counter < 160) { }
+void irq_init() {
+    *interrupt_master = 0;
+    for (int i = 0; i < NUM_IRQS; i++) {
+        irq_handlers[i] = 0;
+    }
+    *interrupt_enable = 0;
+    *interrupt_flags = 0xffff;
+    *bios_interrupt_flags = 0;
+    *bios_interrupt_handler = irq_dispatch;
+    *interrupt_master = 1;
 }
 
-unsigned char button_pressed(unsigned short button) {
-    unsigned short pressed = *buttons & button;
+unsigned short irq_dispstat_bit(enum Interrupt irq) {
+    switch (irq) {
+        case IRQ_VBLANK: return DISPSTAT_VBLANK_IRQ;
+        case IRQ_HBLANK: return DISPSTAT_HBLANK_IRQ;
+        case IRQ_VCOUNT: return DISPSTAT_VCOUNT_IRQ;
+        default: return 0;
+    }
+}
 
-    if (pressed == 0) {
-        return 1;
-    } else {
+/* a null handler still enables the interrupt, which is enough to wake vblank_intr_wait */
+void irq_set(enum Interrupt irq, irq_handler handler) {
+    unsigned short ime = *interrupt_master;
+    *interrupt_master = 0;
+    irq_handlers[irq] = handler;
+    *display_status |= irq_dispstat_bit(irq);
+    *interrupt_enable |= (1 << irq);
+    *interrupt_master = ime;
+}
+
+/* the most a frame queues: one image per entity, the OAM span, the HUD row and the profile overlay */
+#define MAX_TRANSFERS (MAX_ENTITIES + 3)
+#define TRANSFER_BUDGET 6144
+
+#define TRANSFER_OAM 0
+#define TRANSFER_TILES 1
+#define TRANSFER_MAP 2
+#define TRANSFER_LOW 3
+
+/* a copy deferred to the next VBlank, size is in bytes */
+struct Transfer {
+    const unsigned char* source;
+    volatile unsigned char* dest;
+    int size;
+    int wide;
+    int priority;
+};
+
+struct TransferStats {
+    unsigned int queued;
+    unsigned int flushed;
+    unsigned int deferred;
+};
+
+struct Transfer transfers[MAX_TRANSFERS];
+int transfer_count = 0;
+int transfer_budget = TRANSFER_BUDGET;
+volatile int transfer_ready = 0;
+
+/* bytes for the frame being built, and for the last VBlank flush */
+struct TransferStats transfer_stats;
+struct TransferStats transfer_last;
+
+/* keeps the queue in priority order, equal priorities stay first come first served */
+int transfer_push(const void* source, volatile void* dest, int size, int wide, int priority) {
+    unsigned short ime = *interrupt_master;
+    *interrupt_master = 0;
+
+    if (transfer_count == MAX_TRANSFERS) {
+        *interrupt_master = ime;
         return 0;
     }
+
+    int i = transfer_count++;
+    while (i > 0 && transfers[i - 1].priority > priority) {
+        transfers[i] = transfers[i - 1];
+        i--;
+    }
+
+    transfers[i].source = (const unsigned char*) source;
+    transfers[i].dest = (volatile unsigned char*) dest;
+    transfers[i].size = size;
+    transfers[i].wide = wide;
+    transfers[i].priority = priority;
+    transfer_stats.queued += size;
+
+    *interrupt_master = ime;
+    return 1;
+}
+
+/* marks the frame's jobs complete so the next VBlank may flush them */
+void transfer_commit() {
+    transfer_ready = 1;
+}
+
+/* runs from the VBlank interrupt, splitting the job that crosses the budget */
+void transfer_flush() {
+    int budget = transfer_budget;
+    int done = 0;
+
+    while (done < transfer_count && budget > 0) {
+        struct Transfer* job = &transfers[done];
+        int unit = job->wide ? 4 : 2;
+        int size = job->size <= budget ? job->size : budget & ~(unit - 1);
+        if (size == 0) {
+            break;
+        }
+
+        if (job->wide) {
+            memcpy32_dma((unsigned int*) job->dest, (unsigned int*) job->source, size / 4);
+        } else {
+            memcpy16_dma((unsigned short*) job->dest, (unsigned short*) job->source, size / 2);
+        }
+
+        budget -= size;
+        transfer_stats.flushed += size;
+        if (size < job->size) {
+            job->source += size;
+            job->dest += size;
+            job->size -= size;
+            break;
+        }
+        done++;
+    }
+
+    for (int i = done; i < transfer_count; i++) {
+        transfers[i - done] = transfers[i];
+        transfer_stats.deferred += transfers[i].size;
+    }
+    transfer_count -= done;
+
+    transfer_last = transfer_stats;
+    transfer_stats.queued = 0;
+    transfer_stats.flushed = 0;
+    transfer_stats.deferred = 0;
+}
+
+/* per-scanline values fed to one register by HBlank DMA, entry 0 is written at VBlank */
+#define RASTER_LINES (SCREEN_HEIGHT + 1)
+#define MAX_RASTER_BANDS 8
+
+/* a band runs from its first line to the next band's, speed is in 1/256ths of the scroll */
+struct RasterBand {
+    int line;
+    int speed;
+};
+
+/* sky, mountains and trees on the background layer, whose 32 column level always fits the scroller ring */
+const struct RasterBand background_bands[] = {
+    {0, 64},
+    {48, 128},
+    {96, 256},
+};
+
+#define NUM_BACKGROUND_BANDS (sizeof(background_bands) / sizeof(background_bands[0]))
+
+IWRAM_DATA unsigned short raster_tables[2][RASTER_LINES] __attribute__((aligned(4)));
+volatile unsigned short* raster_target = 0;
+volatile int raster_front = 0;
+volatile int raster_ready = 0;
+
+/* scroll registers are write-only, so both tables start from the caller's x */
+void raster_init(volatile short* target, int x) {
+    raster_target = (volatile unsigned short*) target;
+    raster_front = 0;
+    raster_ready = 0;
+    for (int line = 0; line < RASTER_LINES; line++) {
+        raster_tables[0][line] = x;
+        raster_tables[1][line] = x;
+    }
+}
+
+/* fills the back table, which the DMA never reads until raster_commit swaps it in */
+void raster_build(const struct RasterBand* bands, int count, int x) {
+    raster_ready = 0;
+
+    unsigned short* table = raster_tables[raster_front ^ 1];
+    for (int band = 0; band < count; band++) {
+        int end = band + 1 < count ? bands[band + 1].line : RASTER_LINES;
+        unsigned short value = (x * bands[band].speed) >> 8;
+        for (int line = bands[band].line; line < end; line++) {
+            table[line] = value;
+        }
+    }
+}
+
+void raster_commit() {
+    raster_ready = 1;
+}
+
+/* runs from the VBlank interrupt, restarting the HBlank DMA at the top of the table */
+void raster_vblank() {
+    if (!raster_target) {
+        return;
+    }
+
+    dma0_stop();
+    if (raster_ready) {
+        raster_front ^= 1;
+        raster_ready = 0;
+    }
+
+    const unsigned short* table = raster_tables[raster_front];
+    *raster_target = table[0];
+    dma0_hblank(raster_target, &table[1]);
+}
+
+volatile unsigned int vblank_count = 0;
+
+void vblank_tick() {
+    vblank_count++;
+
+    raster_vblank();
+
+    if (transfer_ready) {
+        transfer_flush();
+        transfer_ready = 0;
+    }
+}
+
+#define TICK_RATE 60
+#define MAX_CATCHUP_TICKS 4
+
+struct Scheduler {
+    unsigned int vblanks_per_tick;
+    unsigned int next_tick;
+    unsigned int ticks;
+    unsigned int overruns;
+    unsigned int dropped;
+};
+
+void scheduler_resync(struct Scheduler* scheduler) {
+    scheduler->next_tick = vblank_count + scheduler->vblanks_per_tick;
+}
+
+void scheduler_init(struct Scheduler* scheduler, int rate) {
+    scheduler->vblanks_per_tick = 60 / rate;
+    scheduler->ticks = 0;
+    scheduler->overruns = 0;
+    scheduler->dropped = 0;
+    scheduler_resync(scheduler);
+}
+
+/* sleeps until the next tick is due and returns how many simulation ticks to run */
+int scheduler_wait(struct Scheduler* scheduler) {
+    while ((int) (vblank_count - scheduler->next_tick) < 0) {
+        vblank_intr_wait();
+    }
+
+    unsigned int due = (vblank_count - scheduler->next_tick) / scheduler->vblanks_per_tick + 1;
+    scheduler->next_tick += due * scheduler->vblanks_per_tick;
+
+    if (due > 1) {
+        scheduler->overruns++;
+    }
+    if (due > MAX_CATCHUP_TICKS) {
+        scheduler->dropped += due - MAX_CATCHUP_TICKS;
+        due = MAX_CATCHUP_TICKS;
+    }
+
+    scheduler->ticks += due;
+    return due;
+}
+
+struct Input {
+    unsigned short held;
+    unsigned short pressed;
+    unsigned short released;
+};
+
+struct Input input;
+
+enum InputMode {
+    INPUT_LIVE,
+    INPUT_RECORD,
+    INPUT_REPLAY
+};
+
+/* SRAM layout: magic, frame count, then keys and state checksum per frame */
+#define REPLAY_MAGIC 0x52504c59
+#define REPLAY_HEADER 8
+#define REPLAY_FRAME_SIZE 4
+#define REPLAY_SRAM_SIZE 0x6000
+#define REPLAY_MAX_FRAMES ((REPLAY_SRAM_SIZE - REPLAY_HEADER) / REPLAY_FRAME_SIZE)
+
+enum InputMode input_mode = INPUT_LIVE;
+unsigned int input_frame = 0;
+unsigned int replay_frames = 0;
+int replay_divergence = -1;
+
+unsigned int sram_read32(int offset) {
+    return sram[offset] | ((unsigned int) sram[offset + 1] << 8) | ((unsigned int) sram[offset + 2] << 16) | ((unsigned int) sram[offset + 3] << 24);
+}
+
+void sram_write32(int offset, unsigned int value) {
+    sram[offset] = value;
+    sram[offset + 1] = value >> 8;
+    sram[offset + 2] = value >> 16;
+    sram[offset + 3] = value >> 24;
+}
+
+unsigned short sram_read16(int offset) {
+    return sram[offset] | (sram[offset + 1] << 8);
+}
+
+void sram_write16(int offset, unsigned short value) {
+    sram[offset] = value;
+    sram[offset + 1] = value >> 8;
+}
+
+unsigned short input_read() {
+    return ~*buttons & BUTTON_MASK;
+}
+
+void input_latch(unsigned short keys) {
+    input.pressed = keys & ~input.held;
+    input.released = input.held & ~keys;
+    input.held = keys;
+}
+
+int input_held(unsigned short button) {
+    return (input.held & button) != 0;
+}
+
+int input_pressed(unsigned short button) {
+    return (input.pressed & button) != 0;
+}
+
+/* holding L at boot records a session to SRAM, holding R replays it */
+void input_init() {
+    unsigned short boot = input_read();
+    input.held = input.pressed = input.released = 0;
+    input_frame = 0;
+    replay_divergence = -1;
+
+    if (boot & BUTTON_L) {
+        input_mode = INPUT_RECORD;
+        sram_write32(0, REPLAY_MAGIC);
+        sram_write32(4, 0);
+    } else if ((boot & BUTTON_R) && sram_read32(0) == REPLAY_MAGIC) {
+        input_mode = INPUT_REPLAY;
+        replay_frames = sram_read32(4);
+    } else {
+        input_mode = INPUT_LIVE;
+    }
+}
+
+/* latches one snapshot per tick, from KEYINPUT or the recording */
+void input_update() {
+    int offset = REPLAY_HEADER + input_frame * REPLAY_FRAME_SIZE;
+
+    if (input_mode == INPUT_REPLAY && input_frame >= replay_frames) {
+        input_mode = INPUT_LIVE;
+    }
+    if (input_mode == INPUT_RECORD && input_frame >= REPLAY_MAX_FRAMES) {
+        input_mode = INPUT_LIVE;
+    }
+
+    if (input_mode == INPUT_REPLAY) {
+        input_latch(sram_read16(offset));
+    } else {
+        input_latch(input_read());
+        if (input_mode == INPUT_RECORD) {
+            sram_write16(offset, input.held);
+        }
+    }
+}
+
+/* logs the state checksum beside the recorded keys, or checks it against them */
+void input_checksum(unsigned short checksum) {
+    int offset = REPLAY_HEADER + input_frame * REPLAY_FRAME_SIZE + 2;
+
+    if (input_mode == INPUT_RECORD) {
+        sram_write16(offset, checksum);
+        sram_write32(4, input_frame + 1);
+    } else if (input_mode == INPUT_REPLAY) {
+        if (replay_divergence < 0 && sram_read16(offset) != checksum) {
+            replay_divergence = input_frame;
+            bg_palette[0] = 0x001f;
+#ifdef HOST
+            fprintf(stderr, "replay diverged at frame %d\n", replay_divergence);
+#endif
+        }
+    }
+
+    input_frame++;
+}
+
+/* expands the 1bpp font to 4bpp tiles using colour 1 of the given palette bank */
+void font_load(volatile unsigned short* tiles, int bank, unsigned short color) {
+    bg_palette[bank * 16 + 1] = color;
+
+    for (int i = 0; i < font_count * 8; i++) {
+        unsigned char bits = font_data[i];
+        unsigned int row = 0;
+        for (int x = 0; x < 8; x++) {
+            if (bits & (1 << x)) {
+                row |= 1 << (x * 4);
+            }
+        }
+        tiles[i * 2] = row;
+        tiles[i * 2 + 1] = row >> 16;
+    }
 }
 
-volatile unsigned short* char_block(unsigned long block) {
-    return (volatile unsigned short*) (0x6000000 + (block * 0x4000));
+unsigned short font_entry(char c, int bank) {
+    if (c >= 'a' && c <= 'z') {
+        c -= 'a' - 'A';
+    }
+    if (c < font_first || c >= font_first + font_count) {
+        c = ' ';
+    }
+    return (c - font_first) | (bank << 12);
+}
+
+enum ProfileZoneId {
+    ZONE_FRAME,
+    ZONE_VBLANK,
+    ZONE_INPUT,
+    ZONE_PHYSICS,
+    ZONE_CONTROL,
+    ZONE_ENEMIES,
+    ZONE_COMBAT,
+    ZONE_ANIMATE,
+    ZONE_OVER,
+    NUM_ZONES
+};
+
+const char* const profile_zone_names[NUM_ZONES] = {
+    "FRAME", "VBLANK", "INPUT", "PHYSICS", "CONTROL", "ENEMIES", "COMBAT", "ANIMATE", "OVER"
+};
+
+/* cycles on hardware, nanoseconds in the host build */
+struct ProfileZone {
+    unsigned int min, max, sum, count;
+    unsigned int window_min, window_avg, window_max;
+};
+
+#define PROFILE_WINDOW 64
+
+#define PROFILE_BEGIN(zone) unsigned int profile_start_##zone = hal_clock()
+#define PROFILE_END(zone) profile_record(zone, hal_clock() - profile_start_##zone)
+
+/* SRAM layout: magic, zone count, window length, windows written, zone names, then a ring of windows */
+#define PROFILE_SRAM 0x6000
+#define PROFILE_MAGIC 0x464f5250
+#define PROFILE_NAME_SIZE 8
+#define PROFILE_MAX_ZONES 16
+#define PROFILE_RECORDS (PROFILE_SRAM + 12 + PROFILE_MAX_ZONES * PROFILE_NAME_SIZE)
+#define PROFILE_RECORD_SIZE (4 + NUM_ZONES * 12)
+#define PROFILE_MAX_RECORDS ((SRAM_SIZE - PROFILE_RECORDS) / PROFILE_RECORD_SIZE)
+
+#define PROFILE_BANK 15
+#define PROFILE_CHAR_BLOCK 1
+#define PROFILE_SCREEN_BLOCK 28
+
+/* the header row, a blank row, then one row per zone */
+#define PROFILE_ROWS (NUM_ZONES + 2)
+
+struct ProfileZone profile_zones[NUM_ZONES];
+unsigned int profile_frames = 0;
+unsigned int profile_windows = 0;
+int profile_overlay = 0;
+
+/* the overlay's top rows, drawn here and queued for VBlank as one job */
+unsigned short profile_cells[PROFILE_ROWS][32] __attribute__((aligned(4)));
+int profile_pending = 0;
+
+void profile_reset_window() {
+    for (int z = 0; z < NUM_ZONES; z++) {
+        profile_zones[z].min = 0xffffffff;
+        profile_zones[z].max = 0;
+        profile_zones[z].sum = 0;
+        profile_zones[z].count = 0;
+    }
+    profile_frames = 0;
+}
+
+void profile_init() {
+    profile_reset_window();
+    profile_windows = 0;
+
+    sram_write32(PROFILE_SRAM, PROFILE_MAGIC);
+    sram_write16(PROFILE_SRAM + 4, NUM_ZONES);
+    sram_write16(PROFILE_SRAM + 6, PROFILE_WINDOW);
+    sram_write32(PROFILE_SRAM + 8, 0);
+    for (int z = 0; z < NUM_ZONES; z++) {
+        const char* name = profile_zone_names[z];
+        for (int c = 0; c < PROFILE_NAME_SIZE; c++) {
+            sram[PROFILE_SRAM + 12 + z * PROFILE_NAME_SIZE + c] = *name ? *name++ : 0;
+        }
+    }
+
+    font_load(char_block(PROFILE_CHAR_BLOCK), PROFILE_BANK, 0x7fff);
+    *bg2_control = 0 |
+        (PROFILE_CHAR_BLOCK << 2) |
+        (PROFILE_SCREEN_BLOCK << 8);
+    volatile unsigned short* screen = screen_block(PROFILE_SCREEN_BLOCK);
+    for (int i = 0; i < 32 * 32; i++) {
+        screen[i] = font_entry(' ', PROFILE_BANK);
+    }
+    for (int row = 0; row < PROFILE_ROWS; row++) {
+        for (int column = 0; column < 32; column++) {
+            profile_cells[row][column] = font_entry(' ', PROFILE_BANK);
+        }
+    }
+    profile_pending = 0;
+}
+
+void profile_record(enum ProfileZoneId zone, unsigned int elapsed) {
+    struct ProfileZone* z = &profile_zones[zone];
+    if (elapsed < z->min) {
+        z->min = elapsed;
+    }
+    if (elapsed > z->max) {
+        z->max = elapsed;
+    }
+    z->sum += elapsed;
+    z->count++;
+}
+
+void profile_print(unsigned short* screen, int column, const char* text) {
+    while (*text) {
+        screen[column++] = font_entry(*text++, PROFILE_BANK);
+    }
+}
+
+void profile_print_number(unsigned short* screen, int column, int width, unsigned int value) {
+    for (int i = width - 1; i >= 0; i--) {
+        screen[column + i] = font_entry(i == width - 1 || value ? '0' + value % 10 : ' ', PROFILE_BANK);
+        value /= 10;
+    }
+}
+
+/* a full queue leaves the job pending for the next frame */
+void profile_commit() {
+    profile_pending = !transfer_push(profile_cells, screen_block(PROFILE_SCREEN_BLOCK), sizeof(profile_cells), 1, TRANSFER_LOW);
+}
+
+void profile_draw() {
+    profile_print(profile_cells[0], 1, "ZONE        MIN    AVG    MAX");
+    for (int z = 0; z < NUM_ZONES; z++) {
+        unsigned short* row = profile_cells[z + 2];
+        profile_print(row, 1, "        ");
+        profile_print(row, 1, profile_zone_names[z]);
+        profile_print_number(row, 9, 7, profile_zones[z].window_min);
+        profile_print_number(row, 16, 7, profile_zones[z].window_avg);
+        profile_print_number(row, 23, 7, profile_zones[z].window_max);
+    }
+    profile_commit();
+}
+
+void profile_dump() {
+    int record = PROFILE_RECORDS + (profile_windows % PROFILE_MAX_RECORDS) * PROFILE_RECORD_SIZE;
+    sram_write32(record, profile_windows);
+    for (int z = 0; z < NUM_ZONES; z++) {
+        sram_write32(record + 4 + z * 12, profile_zones[z].window_min);
+        sram_write32(record + 8 + z * 12, profile_zones[z].window_avg);
+        sram_write32(record + 12 + z * 12, profile_zones[z].window_max);
+    }
+    profile_windows++;
+    sram_write32(PROFILE_SRAM + 8, profile_windows);
 }
 
-volatile unsigned short* screen_block(unsigned long block) {
-    return (volatile unsigned short*) (0x6000000 + (block * 0x800));
+/* call once per frame, publishes min/avg/max every PROFILE_WINDOW frames */
+void profile_frame() {
+    if (profile_pending) {
+        profile_commit();
+    }
+    if (input_pressed(BUTTON_SELECT)) {
+        profile_overlay = !profile_overlay;
+        *display_control ^= BG2_ENABLE;
+    }
+
+    if (++profile_frames < PROFILE_WINDOW) {
+        return;
+    }
+
+    for (int z = 0; z < NUM_ZONES; z++) {
+        struct ProfileZone* zone = &profile_zones[z];
+        zone->window_min = zone->count ? zone->min : 0;
+        zone->window_max = zone->max;
+        zone->window_avg = zone->count ? zone->sum / zone->count : 0;
+    }
+
+    profile_dump();
+    if (profile_overlay) {
+        profile_draw();
+    }
+    profile_reset_window();
 }
 
-#define DMA_ENABLE 0x80000000
+#define ASSET_RAW 0x00
+#define ASSET_LZ77 0x10
+#define ASSET_HUFFMAN 0x20
+#define ASSET_RLE 0x30
+
+/* a packed blob from assets.h, starting with a BIOS decompression header */
+struct Asset {
+    const char* name;
+    const unsigned char* data;
+    int packed_size;
+};
+
+#define ASSET(name) {#name, name##_packed, sizeof(name##_packed)}
+
+const struct Asset asset_background_data = ASSET(background_data);
+const struct Asset asset_background_palette = ASSET(background_palette);
+const struct Asset asset_link_data = ASSET(link_data);
+const struct Asset asset_link_palette = ASSET(link_palette);
+const struct Asset asset_map = ASSET(map);
+const struct Asset asset_map2 = ASSET(map2);
+const struct Asset asset_map_linear = ASSET(map_linear);
+const struct Asset asset_map2_linear = ASSET(map2_linear);
+
+struct AssetLoad {
+    const char* name;
+    int size;
+    int packed_size;
+    int codec;
+    unsigned int clock;
+};
 
-#define DMA_16 0x00000000
-#define DMA_32 0x04000000
+#define MAX_ASSET_LOADS 16
 
-volatile unsigned int* dma_source = (volatile unsigned int*) 0x40000D4;
+struct AssetLoad asset_report[MAX_ASSET_LOADS];
+int asset_report_count = 0;
 
-volatile unsigned int* dma_destination = (volatile unsigned int*) 0x40000D8;
+/* destinations on the 16-bit bus get the VRAM-safe BIOS variants */
+void asset_load(const struct Asset* asset, void* dest) {
+    const unsigned char* data = asset->data;
+    int codec = data[0] & 0xf0;
+    int size = data[1] | (data[2] << 8) | (data[3] << 16);
+    int vram = hal_is_vram(dest);
+    unsigned int start = hal_clock();
 
-volatile unsigned int* dma_count = (volatile unsigned int*) 0x40000DC;
+    switch (codec) {
+        case ASSET_LZ77:
+            if (vram) {
+                lz77_uncomp_vram(data, dest);
+            } else {
+                lz77_uncomp_wram(data, dest);
+            }
+            break;
+        case ASSET_HUFFMAN:
+            huff_uncomp(data, dest);
+            break;
+        case ASSET_RLE:
+            if (vram) {
+                rl_uncomp_vram(data, dest);
+            } else {
+                rl_uncomp_wram(data, dest);
+            }
+            break;
+        default:
+            memcpy16_dma((unsigned short*) dest, (unsigned short*) (data + 4), size / 2);
+            break;
+    }
 
-void memcpy16_dma(unsigned short* dest, unsigned short* source, int amount) {
-    *dma_source = (unsigned int) source;
-    *dma_destination = (unsigned int) dest;
-    *dma_count = amount | DMA_16 | DMA_ENABLE;
+    if (asset_report_count < MAX_ASSET_LOADS) {
+        struct AssetLoad* load = &asset_report[asset_report_count++];
+        load->name = asset->name;
+        load->size = size;
+        load->packed_size = asset->packed_size;
+        load->codec = codec;
+        load->clock = hal_clock() - start;
+    }
 }
 
 void setup_background() {
-    memcpy16_dma((unsigned short*) bg_palette, (unsigned short*) background_palette, PALETTE_SIZE);
+    asset_load(&asset_background_palette, (void*) bg_palette);
 
-    memcpy16_dma((unsigned short*) char_block(0), (unsigned short*) background_data, (background_width * background_height) / 2);
+    asset_load(&asset_background_data, (void*) char_block(0));
 
-    *bg0_control = 1 |
+    *bg0_control = 2 |
         (0 << 2) |
-        (0 << 6) |
-        (1 << 7) |
+        (1 << 6) |
+        (0 << 7) |
         (16 << 8) |
         (1 << 13) |
         (0 << 14);
 
-    memcpy16_dma((unsigned short*) screen_block(16), (unsigned short*) map, map_width * map_height);
-
-    *bg1_control = 0 |
+    *bg1_control = 1 |
         (0 << 2) |
-        (0 << 6) |
-        (1 << 7) |
+        (1 << 6) |
+        (0 << 7) |
         (24 << 8) |
         (1 << 13) |
         (0 << 14);
+}
+
+/* a level is a row-major tile map of any width and at most 32 rows, wrapping horizontally,
+ * blocks is its screen-block layout when the whole level is one 32x32 screen block;
+ * tiles holds the original tile ids, remap turns one into the map entry for the deduped tiles in VRAM */
+struct Level {
+    const unsigned short* tiles;
+    int width;
+    int height;
+    const struct Asset* blocks;
+    const unsigned short* remap;
+};
+
+EWRAM_DATA unsigned short level_background_tiles[map_width * map_height] __attribute__((aligned(4)));
+EWRAM_DATA unsigned short level_foreground_tiles[map2_width * map2_height] __attribute__((aligned(4)));
+
+const struct Level level_background = {level_background_tiles, map_width, map_height,
+    map_width == 32 && map_height == 32 ? &asset_map : 0, background_remap};
+const struct Level level_foreground = {level_foreground_tiles, map2_width, map2_height,
+    map2_width == 32 && map2_height == 32 ? &asset_map2 : 0, background_remap};
+
+void setup_levels() {
+    asset_load(&asset_map_linear, level_background_tiles);
+    asset_load(&asset_map2_linear, level_foreground_tiles);
+}
+
+/* streams a level through a 32x32 screen block used as a ring of columns, x_scroll may be 0 when raster DMA drives the layer */
+struct Scroller {
+    const struct Level* level;
+    volatile unsigned short* screen;
+    volatile short* x_scroll;
+    int first;
+};
+
+void scroller_column(struct Scroller* scroller, int column) {
+    const struct Level* level = scroller->level;
+    int source = column % level->width;
+    if (source < 0) {
+        source += level->width;
+    }
+
+    const unsigned short* tile = level->tiles + source;
+    volatile unsigned short* dest = scroller->screen + (column & 31);
+    for (int row = 0; row < level->height; row++) {
+        *dest = level->remap[*tile & 0x3ff] ^ (*tile & 0x0c00);
+        dest += 32;
+        tile += level->width;
+    }
+}
+
+void scroller_fill(struct Scroller* scroller) {
+    for (int column = scroller->first; column < scroller->first + 32; column++) {
+        scroller_column(scroller, column);
+    }
+}
+
+void scroller_init(struct Scroller* scroller, const struct Level* level, volatile unsigned short* screen, volatile short* x_scroll, int x) {
+    scroller->level = level;
+    scroller->screen = screen;
+    scroller->x_scroll = x_scroll;
+    scroller->first = x >> 3;
 
-    memcpy16_dma((unsigned short*) screen_block(24), (unsigned short*) map2, map_width * map_height);
+    if (level->blocks) {
+        asset_load(level->blocks, (void*) screen);
+    } else {
+        for (int i = 0; i < 32 * 32; i++) {
+            screen[i] = 0;
+        }
+        scroller_fill(scroller);
+    }
+    if (x_scroll) {
+        *x_scroll = x;
+    }
 }
 
-void delay(unsigned int amount) {
-    for (int i=0; i < amount * 10; i++);
+/* writes only the columns that scrolled into the ring, straight to the screen block rather than
+ * through the transfer queue, so call it right after the VBlank wake-up */
+void scroller_scroll(struct Scroller* scroller, int x) {
+    int first = x >> 3;
+
+    /* a single screen block level is all in the ring already */
+    if (scroller->level->blocks) {
+        first = scroller->first;
+    }
+
+    if (first - scroller->first >= 32 || scroller->first - first >= 32) {
+        scroller->first = first;
+        scroller_fill(scroller);
+    }
+    while (scroller->first < first) {
+        scroller_column(scroller, scroller->first + 32);
+        scroller->first++;
+    }
+    while (scroller->first > first) {
+        scroller->first--;
+        scroller_column(scroller, scroller->first);
+    }
+
+    if (scroller->x_scroll) {
+        *scroller->x_scroll = x;
+    }
 }
 
 struct Sprite {
@@ -126,8 +860,32 @@ struct Sprite {
     unsigned short attribute3;
 };
 
-struct Sprite sprites[NUM_SPRITES];
-int next_sprite_index = 0;
+IWRAM_DATA unsigned char debruijn_ctz[32] = {
+    0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+    31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+};
+
+IWRAM_CODE int count_trailing_zeros(unsigned int value) {
+    return debruijn_ctz[((value & -value) * 0x077cb531) >> 27];
+}
+
+/* attribute 0 with the OBJ disable bit set, one write hides a sprite */
+#define SPRITE_HIDDEN 0x0200
+
+IWRAM_DATA struct Sprite sprites[NUM_SPRITES] __attribute__((aligned(4)));
+
+/* one bit per free entry, the lowest is handed out first so live sprites stay near the front of OAM */
+IWRAM_DATA unsigned int sprite_free[NUM_SPRITES / 32];
+int sprite_free_count = 0;
+
+/* one bit per entry of the sprites shadow that differs from OAM */
+IWRAM_DATA unsigned int sprite_dirty[NUM_SPRITES / 32];
+unsigned int oam_bytes_uploaded = 0;
+
+IWRAM_CODE void sprite_mark_dirty(struct Sprite* sprite) {
+    int index = sprite - sprites;
+    sprite_dirty[index >> 5] |= 1u << (index & 31);
+}
 
 enum SpritesSize {
     SIZE_8_8,
@@ -144,9 +902,19 @@ enum SpritesSize {
     SIZE_32_64
 };
 
+/* returns 0 when all entries are in use */
 struct Sprite* sprite_init(int x, int y, enum SpritesSize size, int horizontal_flip, int vertical_flip, int tile_index, int priority) {
-    
-    int index = next_sprite_index++;
+    if (sprite_free_count == 0) {
+        return 0;
+    }
+
+    int w = 0;
+    while (sprite_free[w] == 0) {
+        w++;
+    }
+    int index = (w << 5) + count_trailing_zeros(sprite_free[w]);
+    sprite_free[w] &= sprite_free[w] - 1;
+    sprite_free_count--;
 
     int size_bits, shape_bits;
     switch (size) {
@@ -171,7 +939,7 @@ struct Sprite* sprite_init(int x, int y, enum SpritesSize size, int horizontal_f
         (0 << 8) |
         (0 << 10) |
         (0 << 12) |
-        (1 << 13) |
+        (0 << 13) |
         (shape_bits << 14);
 
     sprites[index].attribute1 = x |
@@ -184,27 +952,81 @@ struct Sprite* sprite_init(int x, int y, enum SpritesSize size, int horizontal_f
         (priority << 10) |
         (0 << 12);
 
+    sprite_mark_dirty(&sprites[index]);
     return &sprites[index];
 }
 
+int sprite_is_dirty(int index) {
+    return (sprite_dirty[index >> 5] >> (index & 31)) & 1;
+}
+
+/* queues the entries from the first dirty one to the last as one 32-bit transfer, the clean ones
+ * between already match OAM; when the queue is full everything stays dirty for the next frame */
 void sprite_update_all() {
-    memcpy16_dma((unsigned short*) sprite_attribute_memory, (unsigned short*) sprites, NUM_SPRITES * 4);
+    oam_bytes_uploaded = 0;
+
+    int first = NUM_SPRITES;
+    int last = 0;
+    for (int w = 0; w < NUM_SPRITES / 32; w++) {
+        if (sprite_dirty[w]) {
+            if (first == NUM_SPRITES) {
+                first = (w << 5) + count_trailing_zeros(sprite_dirty[w]);
+            }
+            last = (w << 5) + 31;
+            while (!sprite_is_dirty(last)) {
+                last--;
+            }
+        }
+    }
+    if (first == NUM_SPRITES) {
+        return;
+    }
+
+    int bytes = (last + 1 - first) * sizeof(struct Sprite);
+    if (!transfer_push(&sprites[first], sprite_attribute_memory + first * 4, bytes, 1, TRANSFER_OAM)) {
+        return;
+    }
+    oam_bytes_uploaded = bytes;
+
+    for (int w = 0; w < NUM_SPRITES / 32; w++) {
+        sprite_dirty[w] = 0;
+    }
 }
 
-void sprite_clear() {
-    next_sprite_index = 0;
+void sprite_release(struct Sprite* sprite) {
+    int index = sprite - sprites;
+    unsigned int bit = 1u << (index & 31);
+    if (sprite_free[index >> 5] & bit) {
+        return;
+    }
+
+    sprite->attribute0 = SPRITE_HIDDEN;
+    sprite_mark_dirty(sprite);
+    sprite_free[index >> 5] |= bit;
+    sprite_free_count++;
+}
 
+void sprite_clear() {
     for (int i = 0; i < NUM_SPRITES; i++) {
-        sprites[i].attribute0 = SCREEN_HEIGHT;
-        sprites[i].attribute1 = SCREEN_WIDTH;
+        sprites[i].attribute0 = SPRITE_HIDDEN;
     }
+
+    for (int w = 0; w < NUM_SPRITES / 32; w++) {
+        sprite_free[w] = 0xffffffff;
+        sprite_dirty[w] = 0xffffffff;
+    }
+    sprite_free_count = NUM_SPRITES;
 }
 
-void sprite_position(struct Sprite* sprite, int x, int y) {
-    sprite->attribute0 &= 0xff00;
-    sprite->attribute0 |= (y & 0xff);
-    sprite->attribute1 &= 0xfe00;
-    sprite->attribute1 |= (x & 0x1ff);
+IWRAM_CODE void sprite_position(struct Sprite* sprite, int x, int y) {
+    unsigned short attribute0 = (sprite->attribute0 & 0xff00) | (y & 0xff);
+    unsigned short attribute1 = (sprite->attribute1 & 0xfe00) | (x & 0x1ff);
+
+    if (attribute0 != sprite->attribute0 || attribute1 != sprite->attribute1) {
+        sprite->attribute0 = attribute0;
+        sprite->attribute1 = attribute1;
+        sprite_mark_dirty(sprite);
+    }
 }
 
 void sprite_move(struct Sprite* sprite, int dx, int dy) {
@@ -213,312 +1035,1297 @@ void sprite_move(struct Sprite* sprite, int dx, int dy) {
     sprite_position(sprite, x + dx, y + dy);
 }
 
-void sprite_set_vertical_flip(struct Sprite* sprite, int vertical_flip) {
+IWRAM_CODE void sprite_set_attribute(struct Sprite* sprite, unsigned short* attribute, unsigned short value) {
+    if (*attribute != value) {
+        *attribute = value;
+        sprite_mark_dirty(sprite);
+    }
+}
+
+IWRAM_CODE void sprite_set_vertical_flip(struct Sprite* sprite, int vertical_flip) {
     if (vertical_flip) {
-        sprite->attribute1 |= 0x2000;
+        sprite_set_attribute(sprite, &sprite->attribute1, sprite->attribute1 | 0x2000);
     } else {
-        sprite->attribute1 &= 0xdfff;
+        sprite_set_attribute(sprite, &sprite->attribute1, sprite->attribute1 & 0xdfff);
     }
 }
 
-void sprite_set_horizontal_flip(struct Sprite* sprite, int horizontal_flip) {
+IWRAM_CODE void sprite_set_horizontal_flip(struct Sprite* sprite, int horizontal_flip) {
     if (horizontal_flip) {
-        sprite->attribute1 |= 0x1000;
+        sprite_set_attribute(sprite, &sprite->attribute1, sprite->attribute1 | 0x1000);
     } else {
-        sprite->attribute1 &= 0xefff;
+        sprite_set_attribute(sprite, &sprite->attribute1, sprite->attribute1 & 0xefff);
     }
 }
 
-void sprite_set_offset(struct Sprite* sprite, int offset) {
-    sprite->attribute2 &= 0xfc00;
-    sprite->attribute2 |= (offset & 0x03ff);
+IWRAM_CODE void sprite_set_offset(struct Sprite* sprite, int offset) {
+    sprite_set_attribute(sprite, &sprite->attribute2, (sprite->attribute2 & 0xfc00) | (offset & 0x03ff));
 }
 
-void setup_link_sprite_image() {
-    memcpy16_dma((unsigned short*) sprite_palette, (unsigned short*) link_palette, PALETTE_SIZE);
-    memcpy16_dma((unsigned short*) sprite_image_memory, (unsigned short*) link_data, (link_width * link_height) / 2);
-}
-
-struct Link {
-    struct Sprite* sprite;
-    int x, y;
-    int yvel;
-    int gravity;
-    int frame;
-    int animation_delay;
-    int counter;
-    int move;
-    int border;
-    int falling;
-    int health;
-};
-
-void link_init(struct Link* link) {
-    link->x = 100;
-    link->y = 113;
-    link->yvel = 0;
-    link->gravity = 50;
-    link->border = 40;
-    link->frame = 0;
-    link->move = 1;
-    link->counter = 0;
-    link->falling = 0;
-    link->animation_delay = 8;
-    link->health = 10;
-    link->sprite = sprite_init(link->x, link->y, SIZE_16_32, 0, 0, link->frame, 0);
-}
-
-int link_left(struct Link* link) {
-    sprite_set_horizontal_flip(link->sprite, 1);
-    link->move = 1;
-    if (link->x < link->border) {
-        return 1;
+IWRAM_CODE void sprite_set_hidden(struct Sprite* sprite, int hidden) {
+    if (hidden) {
+        sprite_set_attribute(sprite, &sprite->attribute0, sprite->attribute0 | SPRITE_HIDDEN);
     } else {
-        link->x--;
-        return 0;
+        sprite_set_attribute(sprite, &sprite->attribute0, sprite->attribute0 & ~SPRITE_HIDDEN);
     }
 }
 
-int link_right(struct Link* link) {
-    sprite_set_horizontal_flip(link->sprite, 0);
-    link->move = 1;
-    if (link->x > (SCREEN_WIDTH - 16 - link->border)) {
-        return 1;
-    } else {
-        link->x++;
-        return 0;
-    }
+/* one of the 16 color banks of sprite_palette */
+IWRAM_CODE void sprite_set_palette(struct Sprite* sprite, int bank) {
+    sprite_set_attribute(sprite, &sprite->attribute2, (sprite->attribute2 & 0x0fff) | (bank << 12));
 }
 
-void link_stop(struct Link* link) {
-    link->move = 0;
-    link->frame = 0;
-    link->counter = 7;
-    sprite_set_offset(link->sprite, link->frame);
+/* 16x32 images at 4bpp, stacked vertically in the sheet */
+#define ANIM_FRAME_BYTES (16 * 32 / 2)
+#define ANIM_FRAME_TILES (ANIM_FRAME_BYTES / 32)
+
+/* the sheet stays in EWRAM, only each actor's current image is copied to OBJ VRAM */
+EWRAM_DATA unsigned char link_sheet[link_data_size] __attribute__((aligned(4)));
+
+void setup_link_sprite_image() {
+    asset_load(&asset_link_palette, (void*) sprite_palette);
+    asset_load(&asset_link_data, link_sheet);
 }
 
-void link_jump(struct Link* link) {
-    if (!link->falling) {
-        link->yvel = -1350;
-        link->falling = 1;
+#define COLLISION_WIDTH map2_width
+#define COLLISION_HEIGHT map2_height
+#define COLLISION_ROW_WORDS (COLLISION_WIDTH / 32)
+
+_Static_assert(COLLISION_HEIGHT == 32, "collision_columns holds one 32-bit word per column");
+
+/* map2's solid tiles as packed bitmaps: rows for span tests and the vertical sweep, columns for downward scans and the horizontal one */
+IWRAM_DATA unsigned int collision_rows[COLLISION_HEIGHT][COLLISION_ROW_WORDS];
+IWRAM_DATA unsigned int collision_columns[COLLISION_WIDTH];
+
+int tile_solid(unsigned short tile) {
+    tile &= 0x3ff;
+    return (tile >= 1 && tile <= 6) || (tile >= 12 && tile <= 17);
+}
+
+void collision_init(const unsigned short* tilemap) {
+    for (int ty = 0; ty < COLLISION_HEIGHT; ty++) {
+        for (int w = 0; w < COLLISION_ROW_WORDS; w++) {
+            collision_rows[ty][w] = 0;
+        }
+    }
+    for (int tx = 0; tx < COLLISION_WIDTH; tx++) {
+        collision_columns[tx] = 0;
+    }
+
+    for (int ty = 0; ty < COLLISION_HEIGHT; ty++) {
+        for (int tx = 0; tx < COLLISION_WIDTH; tx++) {
+            if (tile_solid(tilemap[map2_index(tx, ty)])) {
+                collision_rows[ty][tx >> 5] |= 1u << (tx & 31);
+                collision_columns[tx] |= 1u << ty;
+            }
+        }
     }
 }
 
-unsigned short tile_lookup(int x, int y, int xscroll, int yscroll, const unsigned short* tilemap, int tilemap_w, int tilemap_h) {
-    x += xscroll;
-    y += yscroll;
+/* tile coordinates wrap */
+IWRAM_CODE int collision_solid(int tx, int ty) {
+    tx &= COLLISION_WIDTH - 1;
+    ty &= COLLISION_HEIGHT - 1;
+    return (collision_rows[ty][tx >> 5] >> (tx & 31)) & 1;
+}
 
-    x >>= 3;
-    y >>= 3;
+IWRAM_CODE int collision_solid_at(int x, int y) {
+    return collision_solid(x >> 3, y >> 3);
+}
 
-    while (x >= tilemap_w) {
-        x -= tilemap_w;
+/* row of the first solid tile at or below ty in column tx, or -1 */
+IWRAM_CODE int collision_first_solid_below(int tx, int ty) {
+    ty &= COLLISION_HEIGHT - 1;
+    unsigned int below = collision_columns[tx & (COLLISION_WIDTH - 1)] >> ty;
+    if (below == 0) {
+        return -1;
     }
-    while (y >= tilemap_h) {
-        y -= tilemap_h;
+    return ty + count_trailing_zeros(below);
+}
+
+/* whether any tile from tx0 to tx1 (at most 32 apart) on row ty is solid */
+IWRAM_CODE int collision_solid_span(int tx0, int tx1, int ty) {
+    int count = tx1 - tx0 + 1;
+    tx0 &= COLLISION_WIDTH - 1;
+    unsigned int* row = collision_rows[ty & (COLLISION_HEIGHT - 1)];
+    int word = tx0 >> 5;
+    int shift = tx0 & 31;
+
+    unsigned int bits = row[word] >> shift;
+    if (shift) {
+        bits |= row[(word + 1) & (COLLISION_ROW_WORDS - 1)] << (32 - shift);
     }
-    while (x < 0) {
-        x += tilemap_w;
+
+    unsigned int mask = count >= 32 ? 0xffffffff : (1u << count) - 1;
+    return (bits & mask) != 0;
+}
+
+/* rows ty0 to ty1 (at most 32 apart) of column tx */
+IWRAM_CODE int collision_solid_column(int tx, int ty0, int ty1) {
+    int count = ty1 - ty0 + 1;
+    unsigned int bits = collision_columns[tx & (COLLISION_WIDTH - 1)];
+    int shift = ty0 & (COLLISION_HEIGHT - 1);
+    if (shift) {
+        bits = (bits >> shift) | (bits << (32 - shift));
     }
-    while (y < 0) {
-        y += tilemap_h;
+
+    unsigned int mask = count >= 32 ? 0xffffffff : (1u << count) - 1;
+    return (bits & mask) != 0;
+}
+
+/* how far a w x h box at (left, top) can move dx pixels before a solid column, checking every column crossed */
+IWRAM_CODE int collision_sweep_x(int left, int top, int w, int h, int dx) {
+    int ty0 = top >> 3;
+    int ty1 = (top + h - 1) >> 3;
+
+    if (dx > 0) {
+        int right = left + w;
+        for (int tx = ((right - 1) >> 3) + 1; tx <= (right - 1 + dx) >> 3; tx++) {
+            if (collision_solid_column(tx, ty0, ty1)) {
+                return tx * 8 - right;
+            }
+        }
+    } else if (dx < 0) {
+        for (int tx = (left >> 3) - 1; tx >= (left + dx) >> 3; tx--) {
+            if (collision_solid_column(tx, ty0, ty1)) {
+                return (tx + 1) * 8 - left;
+            }
+        }
     }
+    return dx;
+}
 
-    int offset = 0;
+/* the same along y, checking every row crossed */
+IWRAM_CODE int collision_sweep_y(int left, int top, int w, int h, int dy) {
+    int tx0 = left >> 3;
+    int tx1 = (left + w - 1) >> 3;
 
-    if (tilemap_w == 64 && x >= 32) {
-        x -= 32;
-        offset += 0x400;
+    if (dy > 0) {
+        int bottom = top + h;
+        for (int ty = ((bottom - 1) >> 3) + 1; ty <= (bottom - 1 + dy) >> 3; ty++) {
+            if (collision_solid_span(tx0, tx1, ty)) {
+                return ty * 8 - bottom;
+            }
+        }
+    } else if (dy < 0) {
+        for (int ty = (top >> 3) - 1; ty >= (top + dy) >> 3; ty--) {
+            if (collision_solid_span(tx0, tx1, ty)) {
+                return (ty + 1) * 8 - top;
+            }
+        }
     }
+    return dy;
+}
 
-    if (tilemap_h == 64 && y >= 32) {
-        y -= 32;
-        if (tilemap_w == 64) {
-            offset += 0x800;
+/* 24.8 fixed point, used for positions, velocities and the kinematics parameters */
+typedef int fixed;
+
+#define FIXED_SHIFT 8
+#define FIXED_ONE (1 << FIXED_SHIFT)
+#define INT_TO_FIXED(n) ((n) << FIXED_SHIFT)
+#define FIXED_TO_INT(f) ((f) >> FIXED_SHIFT)
+
+/* offsets are relative to the entity's top-left corner */
+struct Box {
+    short x;
+    short y;
+    short w;
+    short h;
+};
+
+enum EntityType {
+    ENTITY_PLAYER,
+    ENTITY_ENEMY,
+    NUM_ENTITY_TYPES
+};
+
+/* per tick: gravity is added to the y velocity, friction pulls x velocity to 0 when not moving */
+struct EntityInfo {
+    fixed gravity;
+    fixed max_fall;
+    fixed max_speed;
+    fixed friction;
+    fixed jump;
+    struct Box body;
+    int health;
+    int palette;
+};
+
+const struct EntityInfo entity_info[NUM_ENTITY_TYPES] = {
+    {50, INT_TO_FIXED(7), INT_TO_FIXED(1), INT_TO_FIXED(1), 1350, {2, 0, 12, 32}, 10, link_bank},
+    {50, INT_TO_FIXED(7), INT_TO_FIXED(1), INT_TO_FIXED(1), 0, {2, 0, 12, 32}, 10, link_swap_bank}
+};
+
+#define BLOCKED_GROUND 0x01
+#define BLOCKED_CEILING 0x02
+#define BLOCKED_LEFT 0x04
+#define BLOCKED_RIGHT 0x08
+
+#define ANIM_LOOP 0x01
+
+/* raised while a frame is shown, ANIM_EVENT_END once a one-shot clip has finished */
+#define ANIM_EVENT_ATTACK 0x01
+#define ANIM_EVENT_END 0x80
+
+#define ANIM_NO_IMAGE 0xff
+
+struct AnimFrame {
+    unsigned char image;
+    unsigned char duration;
+    unsigned char events;
+};
+
+struct AnimClip {
+    const struct AnimFrame* frames;
+    int count;
+    int flags;
+};
+
+enum AnimClipId {
+    CLIP_IDLE,
+    CLIP_WALK,
+    CLIP_ATTACK,
+    NUM_CLIPS
+};
+
+const struct AnimFrame clip_idle_frames[] = {
+    {0, 255, 0}
+};
+
+const struct AnimFrame clip_walk_frames[] = {
+    {1, 8, 0},
+    {0, 8, 0}
+};
+
+const struct AnimFrame clip_attack_frames[] = {
+    {1, 6, ANIM_EVENT_ATTACK},
+    {0, 6, 0}
+};
+
+const struct AnimClip anim_clips[NUM_CLIPS] = {
+    {clip_idle_frames, 1, ANIM_LOOP},
+    {clip_walk_frames, 2, ANIM_LOOP},
+    {clip_attack_frames, 2, 0}
+};
+
+#define ENEMY_PATROL_RANGE 96
+
+/* structure-of-arrays entity tables, indexed by entity id, entity_x and entity_y are the whole pixels of the fixed world position */
+IWRAM_DATA int entity_x[MAX_ENTITIES];
+IWRAM_DATA int entity_y[MAX_ENTITIES];
+IWRAM_DATA fixed entity_fx[MAX_ENTITIES];
+IWRAM_DATA fixed entity_fy[MAX_ENTITIES];
+IWRAM_DATA fixed entity_vx[MAX_ENTITIES];
+IWRAM_DATA fixed entity_vy[MAX_ENTITIES];
+IWRAM_DATA int entity_counter[MAX_ENTITIES];
+IWRAM_DATA int entity_home[MAX_ENTITIES];
+IWRAM_DATA unsigned char entity_health[MAX_ENTITIES] __attribute__((aligned(4)));
+IWRAM_DATA signed char entity_direction[MAX_ENTITIES];
+IWRAM_DATA unsigned char entity_move[MAX_ENTITIES];
+IWRAM_DATA unsigned char entity_blocked[MAX_ENTITIES];
+IWRAM_DATA unsigned char entity_type[MAX_ENTITIES];
+IWRAM_DATA unsigned char entity_invulnerable[MAX_ENTITIES];
+IWRAM_DATA struct Sprite* entity_sprite[MAX_ENTITIES];
+
+/* clip playback, entity_image is the sheet image resident in the entity's VRAM slot */
+IWRAM_DATA unsigned char entity_clip[MAX_ENTITIES];
+IWRAM_DATA unsigned char entity_clip_frame[MAX_ENTITIES];
+IWRAM_DATA unsigned char entity_image[MAX_ENTITIES];
+IWRAM_DATA unsigned char entity_events[MAX_ENTITIES];
+
+/* live ids packed at the front of entity_active, entity_slot maps an id back to its position */
+IWRAM_DATA unsigned char entity_active[MAX_ENTITIES];
+IWRAM_DATA unsigned char entity_slot[MAX_ENTITIES];
+IWRAM_DATA unsigned char entity_free[MAX_ENTITIES];
+int entity_count = 0;
+int entity_free_count = 0;
+
+/* one bit per entity id, 32 ids to a word */
+#define ENTITY_MASK_WORDS (MAX_ENTITIES / 32)
+
+unsigned int entity_alive_mask[ENTITY_MASK_WORDS];
+unsigned int enemy_mask[ENTITY_MASK_WORDS];
+
+/* entities whose sprite is on screen, set by entities_project */
+unsigned int entity_visible_mask[ENTITY_MASK_WORDS];
+
+/* entities whose current image did not fit in the transfer queue, retried by entities_project */
+unsigned int entity_image_pending[ENTITY_MASK_WORDS];
+
+IWRAM_CODE int entity_mask_test(const unsigned int* mask, int id) {
+    return (mask[id >> 5] >> (id & 31)) & 1;
+}
+
+void entity_mask_set(unsigned int* mask, int id) {
+    mask[id >> 5] |= 1u << (id & 31);
+}
+
+void entity_mask_clear(unsigned int* mask, int id) {
+    mask[id >> 5] &= ~(1u << (id & 31));
+}
+
+/* queues the current frame's image for upload if it is not already in the slot */
+IWRAM_CODE void anim_upload(int id) {
+    const struct AnimFrame* frame = &anim_clips[entity_clip[id]].frames[entity_clip_frame[id]];
+    if (frame->image != entity_image[id]) {
+        const unsigned char* source = link_sheet + frame->image * ANIM_FRAME_BYTES;
+        volatile unsigned short* dest = sprite_image_memory + id * ANIM_FRAME_TILES * 16;
+        if (transfer_push(source, dest, ANIM_FRAME_BYTES, 1, TRANSFER_TILES)) {
+            entity_image[id] = frame->image;
         } else {
-            offset += 0x400;
+            entity_mask_set(entity_image_pending, id);
+            return;
         }
     }
+    entity_mask_clear(entity_image_pending, id);
+}
 
-    int index = y * 32 + x;
-    return tilemap[index + offset];
+/* events fire on or off screen, the image only follows while the entity is visible */
+IWRAM_CODE void anim_show(int id) {
+    entity_events[id] = anim_clips[entity_clip[id]].frames[entity_clip_frame[id]].events;
+    if (entity_mask_test(entity_visible_mask, id)) {
+        anim_upload(id);
+    }
 }
 
-void link_update(struct Link* link, int xscroll) {
-    if (link->falling) {
-        link->y += (link->yvel >> 8);
-        link->yvel += link->gravity;
+/* restarts only when the clip changes */
+IWRAM_CODE void anim_play(int id, enum AnimClipId clip) {
+    if (entity_clip[id] == clip && !(entity_events[id] & ANIM_EVENT_END)) {
+        return;
     }
 
-    unsigned short tile = tile_lookup(link->x + 8, link->y + 32, xscroll, 0, map2, map2_width, map2_height);
+    entity_clip[id] = clip;
+    entity_clip_frame[id] = 0;
+    entity_counter[id] = 0;
+    anim_show(id);
+}
 
-    if ((tile >= 1 && tile <= 6) || (tile >= 12 && tile <= 17)) {
-        link->falling = 0;
-        link->yvel = 0;
+int anim_busy(int id) {
+    return !(anim_clips[entity_clip[id]].flags & ANIM_LOOP) && !(entity_events[id] & ANIM_EVENT_END);
+}
 
-        link->y &= ~0x3;
+/* releases the sprites of any live entities */
+void entities_reset() {
+    for (int i = 0; i < entity_count; i++) {
+        sprite_release(entity_sprite[entity_active[i]]);
+    }
 
-        link->y++;
-    } else {
-        link->falling = 1;
+    entity_count = 0;
+    entity_free_count = MAX_ENTITIES;
+    for (int w = 0; w < ENTITY_MASK_WORDS; w++) {
+        entity_alive_mask[w] = 0;
+        enemy_mask[w] = 0;
+        entity_visible_mask[w] = 0;
+        entity_image_pending[w] = 0;
+    }
+    for (int i = 0; i < MAX_ENTITIES; i++) {
+        entity_free[i] = MAX_ENTITIES - 1 - i;
+    }
+}
+
+/* x and y are world coordinates, the sprite stays hidden until entities_project finds it on screen */
+int entity_spawn(enum EntityType type, int x, int y) {
+    if (entity_free_count == 0) {
+        return -1;
+    }
+
+    int id = entity_free[entity_free_count - 1];
+    struct Sprite* sprite = sprite_init(0, 0, SIZE_16_32, 0, 0, id * ANIM_FRAME_TILES, 0);
+    if (!sprite) {
+        return -1;
+    }
+    sprite_set_hidden(sprite, 1);
+    entity_free_count--;
+    const struct EntityInfo* info = &entity_info[type];
+
+    entity_x[id] = x;
+    entity_y[id] = y;
+    entity_fx[id] = INT_TO_FIXED(x);
+    entity_fy[id] = INT_TO_FIXED(y);
+    entity_vx[id] = 0;
+    entity_vy[id] = 0;
+    entity_home[id] = x;
+    entity_health[id] = info->health;
+    entity_direction[id] = 1;
+    entity_move[id] = 1;
+    entity_blocked[id] = 0;
+    entity_type[id] = type;
+    entity_invulnerable[id] = 0;
+    entity_sprite[id] = sprite;
+    sprite_set_palette(sprite, info->palette);
+
+    entity_image[id] = ANIM_NO_IMAGE;
+    entity_events[id] = 0;
+    entity_clip[id] = NUM_CLIPS;
+    anim_play(id, CLIP_WALK);
+
+    if (entity_health[id] > 0) {
+        entity_mask_set(entity_alive_mask, id);
+    }
+    if (type == ENTITY_ENEMY) {
+        entity_mask_set(enemy_mask, id);
+    }
+
+    entity_slot[id] = entity_count;
+    entity_active[entity_count++] = id;
+    return id;
+}
+
+void entity_despawn(int id) {
+    sprite_release(entity_sprite[id]);
+
+    int slot = entity_slot[id];
+    int last = entity_active[--entity_count];
+    entity_active[slot] = last;
+    entity_slot[last] = slot;
+
+    entity_mask_clear(entity_alive_mask, id);
+    entity_mask_clear(enemy_mask, id);
+    entity_mask_clear(entity_visible_mask, id);
+    entity_mask_clear(entity_image_pending, id);
+    entity_free[entity_free_count++] = id;
+}
+
+void entity_stop(int id) {
+    entity_move[id] = 0;
+    if (!anim_busy(id)) {
+        anim_play(id, CLIP_IDLE);
     }
+}
 
-    if (link->move) {
-        link->counter++;
-        if (link->counter >= link->animation_delay) {
-            link->frame = link->frame + 16;
-            if (link->frame > 16) {
-                link->frame = 0;
+/* integrates velocity and resolves each axis against the collision layer */
+IWRAM_CODE void entities_physics() {
+    for (int i = 0; i < entity_count; i++) {
+        int id = entity_active[i];
+        const struct EntityInfo* info = &entity_info[entity_type[id]];
+        const struct Box* body = &info->body;
+        fixed vx = entity_vx[id];
+        fixed vy = entity_vy[id] + info->gravity;
+        int blocked = 0;
+
+        if (vy > info->max_fall) {
+            vy = info->max_fall;
+        }
+        if (!entity_move[id]) {
+            if (vx > info->friction) {
+                vx -= info->friction;
+            } else if (vx < -info->friction) {
+                vx += info->friction;
+            } else {
+                vx = 0;
             }
-            sprite_set_offset(link->sprite, link->frame);
-            link->counter = 0;
         }
+        if (vx > info->max_speed) {
+            vx = info->max_speed;
+        } else if (vx < -info->max_speed) {
+            vx = -info->max_speed;
+        }
+
+        int x = FIXED_TO_INT(entity_fx[id]);
+        int y = FIXED_TO_INT(entity_fy[id]);
+        int left = x + body->x;
+        int top = y + body->y;
+
+        int dx = FIXED_TO_INT(entity_fx[id] + vx) - x;
+        int moved = collision_sweep_x(left, top, body->w, body->h, dx);
+        if (moved != dx) {
+            entity_fx[id] = INT_TO_FIXED(x + moved);
+            blocked |= dx > 0 ? BLOCKED_RIGHT : BLOCKED_LEFT;
+            vx = 0;
+        } else {
+            entity_fx[id] += vx;
+        }
+        left += moved;
+
+        int dy = FIXED_TO_INT(entity_fy[id] + vy) - y;
+        moved = collision_sweep_y(left, top, body->w, body->h, dy);
+        if (moved != dy) {
+            entity_fy[id] = INT_TO_FIXED(y + moved);
+            blocked |= dy > 0 ? BLOCKED_GROUND : BLOCKED_CEILING;
+            vy = 0;
+        } else {
+            entity_fy[id] += vy;
+        }
+        top += moved;
+
+        /* a body at rest moves less than a pixel per tick, so probe one pixel down */
+        if (!(blocked & BLOCKED_GROUND) && vy >= 0 && collision_sweep_y(left, top, body->w, body->h, 1) == 0) {
+            entity_fy[id] = INT_TO_FIXED(FIXED_TO_INT(entity_fy[id]));
+            blocked |= BLOCKED_GROUND;
+            vy = 0;
+        }
+
+        entity_vx[id] = vx;
+        entity_vy[id] = vy;
+        entity_blocked[id] = blocked;
+        entity_x[id] = FIXED_TO_INT(entity_fx[id]);
+        entity_y[id] = FIXED_TO_INT(entity_fy[id]);
     }
+}
+
+/* steps each clip, a finished one-shot falls back to walking or idling */
+IWRAM_CODE void entities_animate() {
+    for (int i = 0; i < entity_count; i++) {
+        int id = entity_active[i];
+        if (!anim_busy(id)) {
+            anim_play(id, entity_move[id] ? CLIP_WALK : CLIP_IDLE);
+        }
 
-    sprite_position(link->sprite, link->x, link->y);
+        const struct AnimClip* clip = &anim_clips[entity_clip[id]];
+        if (++entity_counter[id] < clip->frames[entity_clip_frame[id]].duration) {
+            continue;
+        }
+
+        entity_counter[id] = 0;
+        if (entity_clip_frame[id] + 1 < clip->count) {
+            entity_clip_frame[id]++;
+            anim_show(id);
+        } else if (clip->flags & ANIM_LOOP) {
+            entity_clip_frame[id] = 0;
+            anim_show(id);
+        } else {
+            entity_events[id] = ANIM_EVENT_END;
+        }
+    }
 }
 
-struct Enemy {
-    struct Sprite* sprite;
-    int x, y;
-    int yvel;
-    int gravity;
-    int frame;
-    int animation_delay;
-    int counter;
-    int move;
-    int border;
-    int falling;
-    int direction;
-    int health;
+/* world to screen for every entity in one pass, sprites that leave the screen are hidden and
+ * left alone, so they cost no OAM upload; one coming back gets its current image, and so does
+ * a visible one whose last upload found the queue full */
+IWRAM_CODE void entities_project(int camera_x) {
+    unsigned int visible[ENTITY_MASK_WORDS] = {0};
+    for (int i = 0; i < entity_count; i++) {
+        int id = entity_active[i];
+        int x = entity_x[id] - camera_x;
+        int y = entity_y[id];
+        if (x <= -16 || x >= SCREEN_WIDTH || y <= -32 || y >= SCREEN_HEIGHT) {
+            continue;
+        }
+
+        entity_mask_set(visible, id);
+        sprite_position(entity_sprite[id], x, y);
+    }
+
+    for (int w = 0; w < ENTITY_MASK_WORDS; w++) {
+        unsigned int changed = visible[w] ^ entity_visible_mask[w];
+        unsigned int upload = (changed | entity_image_pending[w]) & visible[w];
+        entity_visible_mask[w] = visible[w];
+        while (changed) {
+            int id = (w << 5) + count_trailing_zeros(changed);
+            changed &= changed - 1;
+            sprite_set_hidden(entity_sprite[id], !entity_mask_test(visible, id));
+        }
+        while (upload) {
+            int id = (w << 5) + count_trailing_zeros(upload);
+            upload &= upload - 1;
+            anim_upload(id);
+        }
+    }
+}
+
+/* sets each enemy's velocity for the next physics step, turning at the ends of its patrol and at walls */
+IWRAM_CODE void enemies_patrol() {
+    for (int i = 0; i < entity_count; i++) {
+        int id = entity_active[i];
+        if (entity_type[id] != ENTITY_ENEMY || !entity_move[id]) {
+            continue;
+        }
+
+        if (entity_direction[id] == 1) {
+            if (entity_x[id] >= entity_home[id] + ENEMY_PATROL_RANGE || (entity_blocked[id] & BLOCKED_RIGHT)) {
+                entity_direction[id] = -1;
+                sprite_set_horizontal_flip(entity_sprite[id], 1);
+            }
+        } else {
+            if (entity_x[id] <= entity_home[id] - ENEMY_PATROL_RANGE || (entity_blocked[id] & BLOCKED_LEFT)) {
+                entity_direction[id] = 1;
+                sprite_set_horizontal_flip(entity_sprite[id], 0);
+            }
+        }
+        entity_vx[id] = entity_direction[id] * entity_info[ENTITY_ENEMY].max_speed;
+    }
+}
+
+void player_left(int id) {
+    sprite_set_horizontal_flip(entity_sprite[id], 1);
+    entity_move[id] = 1;
+    entity_vx[id] = -entity_info[ENTITY_PLAYER].max_speed;
+}
+
+void player_right(int id) {
+    sprite_set_horizontal_flip(entity_sprite[id], 0);
+    entity_move[id] = 1;
+    entity_vx[id] = entity_info[ENTITY_PLAYER].max_speed;
+}
+
+void player_jump(int id) {
+    if (entity_blocked[id] & BLOCKED_GROUND) {
+        entity_vy[id] = -entity_info[ENTITY_PLAYER].jump;
+    }
+}
+
+#define CAMERA_DEAD_ZONE 24
+#define CAMERA_LOOK_AHEAD 40
+#define CAMERA_SMOOTH_SHIFT 3
+
+/* the left edge of the view in world pixels, as a fixed so slow pans still move smoothly;
+ * the target may drift dead_zone pixels either side of the centre before the camera follows,
+ * and the point followed leads the target by look_ahead ticks of its velocity */
+struct Camera {
+    fixed x;
+    int dead_zone;
+    int look_ahead;
+    int smooth_shift;
 };
 
-void enemy_init(struct Enemy* enemy) {
-    enemy->x = 40;
-    enemy->y = 113;
-    enemy->yvel = 0;
-    enemy->gravity = 50;
-    enemy->border = 40;
-    enemy->frame = 0;
-    enemy->move = 1;
-    enemy->counter = 0;
-    enemy->falling = 0;
-    enemy->animation_delay = 8;
-    enemy->direction = 1;
-    enemy->health = 10;
-    enemy->sprite = sprite_init(enemy->x, enemy->y, SIZE_16_32, 0, 0, enemy->frame, 0);
+void camera_init(struct Camera* camera, int x) {
+    camera->x = INT_TO_FIXED(x);
+    camera->dead_zone = CAMERA_DEAD_ZONE;
+    camera->look_ahead = CAMERA_LOOK_AHEAD;
+    camera->smooth_shift = CAMERA_SMOOTH_SHIFT;
+}
+
+/* eases a 1/2^smooth_shift part of the way toward keeping the target in the dead zone */
+void camera_update(struct Camera* camera, int id) {
+    fixed focus = entity_fx[id] + INT_TO_FIXED(8) + entity_vx[id] * camera->look_ahead;
+    fixed offset = focus - (camera->x + INT_TO_FIXED(SCREEN_WIDTH / 2));
+    fixed dead = INT_TO_FIXED(camera->dead_zone);
+
+    fixed move = 0;
+    if (offset > dead) {
+        move = offset - dead;
+    } else if (offset < -dead) {
+        move = offset + dead;
+    }
+    camera->x += move >> camera->smooth_shift;
 }
 
-void enemy_stop(struct Enemy* enemy) {
-    enemy->move = 0;
-    enemy->frame = 0;
-    enemy->counter = 7;
-    sprite_set_offset(enemy->sprite, enemy->frame);
+int camera_screen_x(const struct Camera* camera) {
+    return FIXED_TO_INT(camera->x);
 }
 
-void enemy_update(struct Enemy* enemy, int xscroll) {
+/* the hitbox is live while any of hit_events is raised, or always when hit_events is 0 */
+struct EntityBoxes {
+    struct Box hurtbox;
+    struct Box hitbox;
+    int hit_events;
+    int hit_damage;
+};
+
+const struct EntityBoxes entity_boxes[NUM_ENTITY_TYPES] = {
+    {{2, 0, 12, 32}, {-8, 4, 32, 24}, ANIM_EVENT_ATTACK, 1},
+    {{2, 0, 12, 32}, {2, 8, 12, 24}, 0, 1}
+};
+
+#define INVULNERABLE_TICKS 20
+
+/* hurtboxes are bucketed by 32 pixel column from grid_origin, usually the camera, so anything off screen lands in the edge columns */
+#define GRID_SHIFT 5
+#define GRID_COLUMNS ((SCREEN_WIDTH >> GRID_SHIFT) + 1)
+
+int grid_origin = 0;
+
+IWRAM_DATA unsigned short grid_start[GRID_COLUMNS + 1];
+IWRAM_DATA unsigned char grid_ids[MAX_ENTITIES * GRID_COLUMNS];
 
-    unsigned short tile = tile_lookup(enemy->x + 8, enemy->y + 16, xscroll, 0, map2, map2_width, map2_height);
+#define MAX_CONTACTS MAX_ENTITIES
 
-    if ((tile >= 1 && tile <= 6) || (tile >= 12 && tile <= 17)) {
-        enemy->falling = 0;
-        enemy->yvel = 0;
-        enemy->y &= ~0x3;
-        enemy->y++;
+struct Contact {
+    unsigned char attacker;
+    unsigned char target;
+    unsigned char amount;
+};
+
+IWRAM_DATA struct Contact contacts[MAX_CONTACTS];
+int contact_count = 0;
+
+IWRAM_CODE int grid_column(int x) {
+    x = (x - grid_origin) >> GRID_SHIFT;
+    if (x < 0) {
+        return 0;
+    }
+    return x < GRID_COLUMNS ? x : GRID_COLUMNS - 1;
+}
+
+/* counting sort of hurtboxes into columns, a box appears once in every column it spans */
+IWRAM_CODE void grid_build() {
+    for (int c = 0; c <= GRID_COLUMNS; c++) {
+        grid_start[c] = 0;
     }
 
-    if (enemy->move){
-        enemy->counter++;
-        if (enemy->counter >= enemy->animation_delay) {
-            enemy->frame = enemy->frame + 16;
-            if (enemy->frame > 16) {
-                enemy->frame = 0;
-            }
-            sprite_set_offset(enemy->sprite, enemy->frame);
-            enemy->counter = 0;
+    for (int i = 0; i < entity_count; i++) {
+        int id = entity_active[i];
+        const struct Box* box = &entity_boxes[entity_type[id]].hurtbox;
+        int last = grid_column(entity_x[id] + box->x + box->w - 1);
+        for (int c = grid_column(entity_x[id] + box->x); c <= last; c++) {
+            grid_start[c + 1]++;
         }
     }
 
-    sprite_position(enemy->sprite, enemy->x, enemy->y);
+    for (int c = 0; c < GRID_COLUMNS; c++) {
+        grid_start[c + 1] += grid_start[c];
+    }
+
+    unsigned short fill[GRID_COLUMNS];
+    for (int c = 0; c < GRID_COLUMNS; c++) {
+        fill[c] = grid_start[c];
+    }
+
+    for (int i = 0; i < entity_count; i++) {
+        int id = entity_active[i];
+        const struct Box* box = &entity_boxes[entity_type[id]].hurtbox;
+        int last = grid_column(entity_x[id] + box->x + box->w - 1);
+        for (int c = grid_column(entity_x[id] + box->x); c <= last; c++) {
+            grid_ids[fill[c]++] = id;
+        }
+    }
 }
 
-int damage(int health);
-int over(int player_health, int cpu_health);
+/* tests live hitboxes against hurtboxes of the other type in the columns they cover */
+IWRAM_CODE void collision_contacts(int origin) {
+    contact_count = 0;
+    grid_origin = origin;
+    grid_build();
+
+    for (int i = 0; i < entity_count; i++) {
+        int attacker = entity_active[i];
+        const struct EntityBoxes* boxes = &entity_boxes[entity_type[attacker]];
+        if (boxes->hit_events && !(entity_events[attacker] & boxes->hit_events)) {
+            continue;
+        }
 
-int main() {
-    *display_control = MODE0 | BG0_ENABLE | BG1_ENABLE | SPRITE_ENABLE | SPRITE_MAP_1D;
-    setup_background();
-    setup_link_sprite_image();
-    sprite_clear();
-    struct Link link;
-    link_init(&link);
-    struct Enemy enemy;
-    enemy_init(&enemy);
-    int xscroll = 0;
-    while (1) {
-        link_update(&link, xscroll);
-        if (button_pressed(BUTTON_RIGHT)) {
-            if (link_right(&link)) {
-                xscroll++;
-            }
-        } else if (button_pressed(BUTTON_LEFT)) {
-            if (link_left(&link)) {
-                xscroll--;
+        int left = entity_x[attacker] + boxes->hitbox.x;
+        int top = entity_y[attacker] + boxes->hitbox.y;
+        int right = left + boxes->hitbox.w;
+        int bottom = top + boxes->hitbox.h;
+        int first = grid_column(left);
+        int last = grid_column(right - 1);
+
+        for (int c = first; c <= last; c++) {
+            for (int j = grid_start[c]; j < grid_start[c + 1]; j++) {
+                int target = grid_ids[j];
+                if (entity_type[target] == entity_type[attacker]) {
+                    continue;
+                }
+
+                const struct Box* hurtbox = &entity_boxes[entity_type[target]].hurtbox;
+                int target_left = entity_x[target] + hurtbox->x;
+                int target_top = entity_y[target] + hurtbox->y;
+
+                /* a pair sharing several columns is reported from the first one only */
+                int target_first = grid_column(target_left);
+                if (c != (target_first > first ? target_first : first)) {
+                    continue;
+                }
+
+                if (left < target_left + hurtbox->w && target_left < right &&
+                        top < target_top + hurtbox->h && target_top < bottom) {
+                    if (contact_count < MAX_CONTACTS) {
+                        struct Contact* contact = &contacts[contact_count++];
+                        contact->attacker = attacker;
+                        contact->target = target;
+                        contact->amount = boxes->hit_damage;
+                    }
+                }
             }
-        } else {
-            link_stop(&link);
         }
+    }
+}
 
-        enemy_update(&enemy, xscroll);
-        
-        if (button_pressed(BUTTON_UP)) {
-            link_jump(&link);
+/* summed damage per entity, only non-zero while combat_resolve runs */
+IWRAM_DATA unsigned char entity_pending[MAX_ENTITIES] __attribute__((aligned(4)));
+
+/* one hit at a time, saturating at 0, sets a bit in died for each entity that died */
+void combat_resolve_reference(unsigned char* health, const struct Contact* hits, int count, unsigned int* died) {
+    for (int w = 0; w < ENTITY_MASK_WORDS; w++) {
+        died[w] = 0;
+    }
+    for (int i = 0; i < count; i++) {
+        int target = hits[i].target;
+        if (health[target] == 0) {
+            continue;
         }
 
-        if (button_pressed(BUTTON_A)) {
-            if  (((&link)->x >= ((&enemy)->x - 24)) && ((&link)->x <= ((&enemy)->x + 24))) {
-                if ((&link)->y >= ((&enemy)->y - 16)) {
-                    (&enemy)->health = damage((&enemy)->health);
+        int left = health[target] - hits[i].amount;
+        health[target] = left > 0 ? left : 0;
+        if (left <= 0) {
+            entity_mask_set(died, target);
+        }
+    }
+}
+
+#define SWAR_HIGH 0x80808080
+#define SWAR_LOW 0x7f7f7f7f
+
+#ifdef HOST
+/* the same steps as combat.s, four healths per word, eight words to a died word */
+void combat_resolve(unsigned char* health, unsigned char* pending, const struct Contact* hits, int count, unsigned int* died) {
+    for (int i = 0; i < count; i++) {
+        int sum = pending[hits[i].target] + hits[i].amount;
+        pending[hits[i].target] = sum > 255 ? 255 : sum;
+    }
+
+    unsigned int bits = 0;
+    for (int w = 0; w < MAX_ENTITIES / 4; w++) {
+        unsigned int x, y;
+        memcpy(&x, health + w * 4, 4);
+        memcpy(&y, pending + w * 4, 4);
+
+        unsigned int diff = ((x | SWAR_HIGH) - (y & ~SWAR_HIGH)) ^ ((x ^ ~y) & SWAR_HIGH);
+        unsigned int borrow = ((y & ~x) | ((~x | y) & diff)) & SWAR_HIGH;
+        unsigned int result = diff & ~((borrow << 1) - (borrow >> 7));
+
+        unsigned int was_nonzero = ((x & SWAR_LOW) + SWAR_LOW) | x;
+        unsigned int is_nonzero = ((result & SWAR_LOW) + SWAR_LOW) | result;
+        unsigned int dead = ((was_nonzero & ~is_nonzero) & SWAR_HIGH) >> 7;
+        bits |= (((dead * 0x00204081) >> 21) & 15) << ((w & 7) * 4);
+        if ((w & 7) == 7) {
+            died[w >> 3] = bits;
+            bits = 0;
+        }
+
+        memcpy(health + w * 4, &result, 4);
+        memset(pending + w * 4, 0, 4);
+    }
+}
+#else
+/* combat.s, ARM code in IWRAM */
+__attribute__((long_call)) void combat_resolve(unsigned char* health, unsigned char* pending, const struct Contact* hits, int count, unsigned int* died);
+#endif
+
+/* applies a batch of hits to entity_health, the host build checks the kernel against the reference */
+void combat_apply(const struct Contact* hits, int count, unsigned int* died) {
+#ifdef HOST
+    unsigned char expected[MAX_ENTITIES];
+    unsigned int expected_died[ENTITY_MASK_WORDS];
+    memcpy(expected, entity_health, MAX_ENTITIES);
+    combat_resolve_reference(expected, hits, count, expected_died);
+#endif
+
+    combat_resolve(entity_health, entity_pending, hits, count, died);
+
+#ifdef HOST
+    if (memcmp(died, expected_died, sizeof(expected_died)) != 0 || memcmp(expected, entity_health, MAX_ENTITIES) != 0) {
+        fprintf(stderr, "combat_resolve disagrees with the reference\n");
+    }
+#endif
+}
+
+/* one row of font and bar cells on BG3, shadowed in hud_cells; only cells whose entry
+ * changed are queued for VBlank, so an unchanged HUD costs no transfer at all */
+#define HUD_BANK 14
+#define HUD_CHAR_BLOCK 1
+#define HUD_SCREEN_BLOCK 30
+#define HUD_ROW 18
+#define HUD_BAR_CELLS 5
+
+/* the bar tiles follow the font, HUD_BAR_TILE + n is a cell with n of its 8 columns filled */
+#define HUD_BAR_TILE font_count
+#define HUD_BAR_FILL 2
+#define HUD_BAR_EMPTY 3
+
+unsigned short hud_cells[32] __attribute__((aligned(4)));
+unsigned int hud_dirty = 0;
+
+void hud_init() {
+    volatile unsigned short* tiles = char_block(HUD_CHAR_BLOCK);
+    font_load(tiles, HUD_BANK, 0x7fff);
+    bg_palette[HUD_BANK * 16 + HUD_BAR_FILL] = 0x03e0;
+    bg_palette[HUD_BANK * 16 + HUD_BAR_EMPTY] = 0x1084;
+
+    /* rows 2 to 5 of each bar tile are filled, 16 bits hold four 4bpp pixels */
+    for (int fill = 0; fill <= 8; fill++) {
+        volatile unsigned short* tile = tiles + (HUD_BAR_TILE + fill) * 16;
+        for (int y = 0; y < 8; y++) {
+            for (int half = 0; half < 2; half++) {
+                unsigned short pixels = 0;
+                for (int x = 0; x < 4 && y >= 2 && y <= 5; x++) {
+                    pixels |= (half * 4 + x < fill ? HUD_BAR_FILL : HUD_BAR_EMPTY) << (x * 4);
                 }
+                tile[y * 2 + half] = pixels;
             }
         }
+    }
 
-        if ((&enemy)->move == 1 && (&enemy)->direction == 1) {
-            if ((&enemy)->x == (SCREEN_WIDTH - 16)) {
-                (&enemy)->direction = -1;
-                sprite_set_horizontal_flip((&enemy)->sprite, 1);
-            } else {
-                (&enemy)->x++;
-            }
+    volatile unsigned short* screen = screen_block(HUD_SCREEN_BLOCK);
+    for (int i = 0; i < 32 * 32; i++) {
+        screen[i] = font_entry(' ', HUD_BANK);
+    }
+    for (int i = 0; i < 32; i++) {
+        hud_cells[i] = font_entry(' ', HUD_BANK);
+    }
+    hud_dirty = 0;
+
+    *bg3_control = 0 |
+        (HUD_CHAR_BLOCK << 2) |
+        (HUD_SCREEN_BLOCK << 8);
+    *display_control |= BG3_ENABLE;
+}
+
+void hud_set(int column, unsigned short entry) {
+    if (hud_cells[column] != entry) {
+        hud_cells[column] = entry;
+        hud_dirty |= 1u << column;
+    }
+}
+
+void hud_text(int column, const char* text) {
+    while (*text) {
+        hud_set(column++, font_entry(*text++, HUD_BANK));
+    }
+}
+
+void hud_number(int column, int width, unsigned int value) {
+    for (int i = width - 1; i >= 0; i--) {
+        hud_set(column + i, font_entry(i == width - 1 || value ? '0' + value % 10 : ' ', HUD_BANK));
+        value /= 10;
+    }
+}
+
+void hud_bar(int column, int value, int max) {
+    int filled = value * HUD_BAR_CELLS * 8 / max;
+    for (int cell = 0; cell < HUD_BAR_CELLS; cell++) {
+        int fill = filled - cell * 8;
+        fill = fill < 0 ? 0 : fill > 8 ? 8 : fill;
+        hud_set(column + cell, (HUD_BAR_TILE + fill) | (HUD_BANK << 12));
+    }
+}
+
+/* the player's health, the first live enemy's health and how many enemies are left */
+void hud_update(int player) {
+    int health = entity_mask_test(entity_alive_mask, player) ? entity_health[player] : 0;
+    hud_text(1, "P");
+    hud_bar(2, health, entity_info[ENTITY_PLAYER].health);
+    hud_number(8, 2, health);
+
+    int enemy_health = 0;
+    int left = 0;
+    for (int w = ENTITY_MASK_WORDS - 1; w >= 0; w--) {
+        unsigned int enemies = entity_alive_mask[w] & enemy_mask[w];
+        if (enemies) {
+            enemy_health = entity_health[(w << 5) + count_trailing_zeros(enemies)];
         }
-        if ((&enemy)->move == 1 && (&enemy)->direction == -1) {
-            if ((&enemy)->x == 0) {
-                (&enemy)->direction = 1;
-                sprite_set_horizontal_flip((&enemy)->sprite, 0);
-            } else {
-                (&enemy)->x--;
-            }
+        for (; enemies; enemies &= enemies - 1) {
+            left++;
         }
+    }
+    hud_text(18, "E");
+    hud_bar(19, enemy_health, entity_info[ENTITY_ENEMY].health);
+    hud_text(25, "X");
+    hud_number(26, 2, left);
+}
 
-        if (((&link)->x == ((&enemy)->x + 16)) || (((&link)->x + 16) == (&enemy)->x)) {
-            if ((&link)->y >= ((&enemy)->y - 16)) {
-                (&link)->health = damage((&link)->health);
-            }
+/* queues the cells from the first dirty one to the last as one job, or keeps them dirty when the queue is full */
+void hud_commit() {
+    if (!hud_dirty) {
+        return;
+    }
+
+    int start = count_trailing_zeros(hud_dirty);
+    int end = 32;
+    while (!((hud_dirty >> (end - 1)) & 1)) {
+        end--;
+    }
+
+    volatile unsigned short* row = screen_block(HUD_SCREEN_BLOCK) + HUD_ROW * 32;
+    if (transfer_push(&hud_cells[start], row + start, (end - start) * 2, 0, TRANSFER_MAP)) {
+        hud_dirty = 0;
+    }
+}
+
+struct Game {
+    int player;
+    struct Camera camera;
+};
+
+void game_init(struct Game* game) {
+    camera_init(&game->camera, 0);
+    entities_reset();
+    game->player = entity_spawn(ENTITY_PLAYER, 100, 112);
+    entity_spawn(ENTITY_ENEMY, 40, 112);
+}
+
+unsigned short game_checksum(struct Game* game) {
+    unsigned int sum = game->camera.x;
+    for (int i = 0; i < entity_count; i++) {
+        int id = entity_active[i];
+        sum = ((sum << 5) | (sum >> 27)) ^ entity_x[id];
+        sum = ((sum << 5) | (sum >> 27)) ^ entity_y[id];
+        sum = ((sum << 5) | (sum >> 27)) ^ entity_health[id];
+    }
+    return sum ^ (sum >> 16);
+}
+
+void game_stop() {
+    for (int i = 0; i < entity_count; i++) {
+        int id = entity_active[i];
+        if (entity_type[id] == ENTITY_ENEMY) {
+            entity_stop(id);
+        }
+    }
+}
+
+int game_update(struct Game* game) {
+    int player = game->player;
+
+    PROFILE_BEGIN(ZONE_PHYSICS);
+    entities_physics();
+    PROFILE_END(ZONE_PHYSICS);
+
+    PROFILE_BEGIN(ZONE_CONTROL);
+    if (input_held(BUTTON_RIGHT)) {
+        player_right(player);
+    } else if (input_held(BUTTON_LEFT)) {
+        player_left(player);
+    } else {
+        entity_stop(player);
+    }
+
+    if (input_held(BUTTON_UP)) {
+        player_jump(player);
+    }
+
+    if (input_pressed(BUTTON_A)) {
+        anim_play(player, CLIP_ATTACK);
+    }
+    PROFILE_END(ZONE_CONTROL);
+
+    PROFILE_BEGIN(ZONE_ENEMIES);
+    enemies_patrol();
+    PROFILE_END(ZONE_ENEMIES);
+
+    PROFILE_BEGIN(ZONE_COMBAT);
+    collision_contacts(camera_screen_x(&game->camera));
+
+    /* drop contacts on invulnerable targets, the first hit each tick starts the invulnerability */
+    int hits = 0;
+    for (int i = 0; i < contact_count; i++) {
+        int target = contacts[i].target;
+        if (entity_invulnerable[target]) {
+            continue;
         }
 
-        if (over((&link)->health, (&enemy)->health)) {
-            enemy_stop(&enemy);
-            delay(100000);
-            sprite_clear();
-            link_init(&link);
-            enemy_init(&enemy);
+        contacts[hits++] = contacts[i];
+        entity_invulnerable[target] = INVULNERABLE_TICKS;
+    }
+
+    /* the dead leave the tables, so they stop moving, touching and drawing */
+    unsigned int died[ENTITY_MASK_WORDS];
+    combat_apply(contacts, hits, died);
+    for (int w = 0; w < ENTITY_MASK_WORDS; w++) {
+        while (died[w]) {
+            entity_despawn((w << 5) + count_trailing_zeros(died[w]));
+            died[w] &= died[w] - 1;
         }
+    }
 
-        wait_vblank();
-        *bg0_x_scroll = xscroll;
-        *bg1_x_scroll = 2 * xscroll;
-        sprite_update_all();
-        delay(300);
+    for (int i = 0; i < entity_count; i++) {
+        int id = entity_active[i];
+        if (entity_invulnerable[id]) {
+            entity_invulnerable[id]--;
+        }
     }
+    PROFILE_END(ZONE_COMBAT);
+
+    PROFILE_BEGIN(ZONE_ANIMATE);
+    if (entity_mask_test(entity_alive_mask, player)) {
+        camera_update(&game->camera, player);
+    }
+    entities_animate();
+    entities_project(camera_screen_x(&game->camera));
+    PROFILE_END(ZONE_ANIMATE);
+
+    PROFILE_BEGIN(ZONE_OVER);
+    unsigned int enemies = 0;
+    for (int w = 0; w < ENTITY_MASK_WORDS; w++) {
+        enemies |= entity_alive_mask[w] & enemy_mask[w];
+    }
+    int game_over = !entity_mask_test(entity_alive_mask, player) || !enemies;
+    PROFILE_END(ZONE_OVER);
+    return game_over;
 }
 
+void game_setup() {
+    irq_init();
+    irq_set(IRQ_VBLANK, vblank_tick);
+    *display_control = MODE0 | BG0_ENABLE | BG1_ENABLE | SPRITE_ENABLE | SPRITE_MAP_1D;
+    setup_background();
+    setup_levels();
+    collision_init(level_foreground.tiles);
+    setup_link_sprite_image();
+    sprite_clear();
+    input_init();
+    profile_init();
+    hud_init();
+}
+
+#define BLEND_BG0 0x01
+#define BLEND_BG1 0x02
+#define BLEND_SPRITES 0x10
+#define BLEND_BACKDROP 0x20
+#define BLEND_DARKEN 0xc0
+
+#define FADE_TICKS 32
+#define HOLD_TICKS 26
+
+enum TransitionState {
+    TRANSITION_NONE,
+    TRANSITION_FADE_OUT,
+    TRANSITION_HOLD,
+    TRANSITION_FADE_IN
+};
+
+/* the game over sequence as a state stepped once per tick: darken and mosaic the
+ * playfield, reset the game while it is black, then bring it back; the HUD on BG3
+ * is not a blend target and stays readable throughout */
+struct Transition {
+    enum TransitionState state;
+    int tick;
+};
+
+void transition_start(struct Transition* transition) {
+    transition->state = TRANSITION_FADE_OUT;
+    transition->tick = 0;
+}
+
+/* returns 1 while the game should not be updated, the game plays again during the fade in */
+int transition_tick(struct Transition* transition, struct Game* game) {
+    switch (transition->state) {
+        case TRANSITION_FADE_OUT:
+            if (++transition->tick == FADE_TICKS) {
+                transition->state = TRANSITION_HOLD;
+                transition->tick = 0;
+            }
+            return 1;
+        case TRANSITION_HOLD:
+            if (++transition->tick == HOLD_TICKS) {
+                game_init(game);
+                transition->state = TRANSITION_FADE_IN;
+                transition->tick = 0;
+            }
+            return 1;
+        case TRANSITION_FADE_IN:
+            if (++transition->tick == FADE_TICKS) {
+                transition->state = TRANSITION_NONE;
+            }
+            return 0;
+        default:
+            return 0;
+    }
+}
+
+/* 0 is the untouched screen, 16 is black */
+int transition_level(struct Transition* transition) {
+    switch (transition->state) {
+        case TRANSITION_FADE_OUT: return transition->tick * 16 / FADE_TICKS;
+        case TRANSITION_HOLD: return 16;
+        case TRANSITION_FADE_IN: return 16 - transition->tick * 16 / FADE_TICKS;
+        default: return 0;
+    }
+}
+
+/* writes the registers directly, so call it right after the VBlank wake-up and the whole frame
+ * is drawn with one level */
+void transition_apply(struct Transition* transition) {
+    int level = transition_level(transition);
+    if (level == 0) {
+        *blend_control = 0;
+        *blend_brightness = 0;
+        *mosaic = 0;
+        return;
+    }
+
+    int size = level >> 1;
+    *blend_control = BLEND_BG0 | BLEND_BG1 | BLEND_SPRITES | BLEND_BACKDROP | BLEND_DARKEN;
+    *blend_brightness = level;
+    *mosaic = size | (size << 4);
+}
+
+/* the state main's loop carries from one frame to the next */
+struct Session {
+    struct Game game;
+    struct Scroller background_scroller;
+    struct Scroller foreground_scroller;
+    struct Scheduler scheduler;
+    struct Transition transition;
+};
+
+/* the foreground, which collision uses, scrolls with the camera and the background at half its speed */
+void session_start(struct Session* session) {
+    game_init(&session->game);
+    int x = camera_screen_x(&session->game.camera);
+    scroller_init(&session->background_scroller, &level_background, screen_block(16), 0, x >> 1);
+    scroller_init(&session->foreground_scroller, &level_foreground, screen_block(24), bg1_x_scroll, x);
+    raster_init(bg0_x_scroll, x >> 1);
+    raster_build(background_bands, NUM_BACKGROUND_BANDS, x >> 1);
+    raster_commit();
+    scheduler_init(&session->scheduler, TICK_RATE);
+    session->transition.state = TRANSITION_NONE;
+    transition_apply(&session->transition);
+}
+
+/* waits for the next tick, runs every tick that is due and queues the frame's uploads */
+void session_frame(struct Session* session) {
+    struct Game* game = &session->game;
+    int ticks = scheduler_wait(&session->scheduler);
+
+    PROFILE_BEGIN(ZONE_FRAME);
+    PROFILE_BEGIN(ZONE_VBLANK);
+    int x = camera_screen_x(&game->camera);
+    scroller_scroll(&session->background_scroller, x >> 1);
+    scroller_scroll(&session->foreground_scroller, x);
+    transition_apply(&session->transition);
+    PROFILE_END(ZONE_VBLANK);
+
+    while (ticks-- > 0) {
+        PROFILE_BEGIN(ZONE_INPUT);
+        input_update();
+        PROFILE_END(ZONE_INPUT);
+        if (transition_tick(&session->transition, game)) {
+            input_checksum(game_checksum(game));
+            continue;
+        }
+
+        int game_over = game_update(game);
+        input_checksum(game_checksum(game));
+        if (game_over) {
+            game_stop();
+            transition_start(&session->transition);
+        }
+    }
+
+    raster_build(background_bands, NUM_BACKGROUND_BANDS, camera_screen_x(&game->camera) >> 1);
+    raster_commit();
+    hud_update(game->player);
+    hud_commit();
+    sprite_update_all();
+    transfer_commit();
+
+    PROFILE_END(ZONE_FRAME);
+    profile_frame();
+}
+
+/* bench.c includes this file and supplies its own main */
+#ifndef BENCH
+int main(int argc, char** argv) {
+    hal_init(argc, argv);
+    game_setup();
+    struct Session session;
+    session_start(&session);
+#ifdef HOST
+    /* after session_start, whose scrollers load the screen-block maps */
+    if (host_asset_report) {
+        for (int i = 0; i < asset_report_count; i++) {
+            struct AssetLoad* load = &asset_report[i];
+            fprintf(stderr, "%-20s %6d -> %6d bytes, codec 0x%02x, %u ns\n", load->name, load->size, load->packed_size, load->codec, load->clock);
+        }
+    }
+#endif
+    while (hal_running()) {
+        session_frame(&session);
+    }
+
+    hal_shutdown();
+    return 0;
+}
+#endif
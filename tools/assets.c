@@ -0,0 +1,547 @@
+/* assets.c
+ * packs the png2gba / GBA Tile Editor headers into BIOS-decompressible blobs,
+ * converting the 8bpp tiles to 4bpp with build-time palette banks
+ *
+ *     gcc -O2 -o assets tools/assets.c && ./assets > assets.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../background.h"
+#include "../link.h"
+#include "../map.h"
+#include "../map2.h"
+
+#define CODEC_RAW 0x00
+#define CODEC_LZ77 0x10
+#define CODEC_HUFFMAN 0x20
+#define CODEC_RLE 0x30
+
+struct Blob {
+    unsigned char* data;
+    int size;
+};
+
+void blob_init(struct Blob* blob, int capacity) {
+    blob->data = malloc(capacity + 8);
+    blob->size = 0;
+}
+
+void blob_byte(struct Blob* blob, unsigned char byte) {
+    blob->data[blob->size++] = byte;
+}
+
+void blob_header(struct Blob* blob, int codec, int size) {
+    blob_byte(blob, codec);
+    blob_byte(blob, size);
+    blob_byte(blob, size >> 8);
+    blob_byte(blob, size >> 16);
+}
+
+void blob_align(struct Blob* blob) {
+    while (blob->size & 3) {
+        blob_byte(blob, 0);
+    }
+}
+
+void pack_raw(struct Blob* out, const unsigned char* data, int size) {
+    blob_init(out, size + 4);
+    blob_header(out, CODEC_RAW, size);
+    for (int i = 0; i < size; i++) {
+        blob_byte(out, data[i]);
+    }
+}
+
+/* matches never start one byte back so the result also suits LZ77UnCompVram */
+void pack_lz77(struct Blob* out, const unsigned char* data, int size) {
+    blob_init(out, size + size / 8 + 4);
+    blob_header(out, CODEC_LZ77, size);
+
+    int pos = 0;
+    while (pos < size) {
+        int flags_at = out->size;
+        unsigned char flags = 0;
+        blob_byte(out, 0);
+
+        for (int bit = 7; bit >= 0 && pos < size; bit--) {
+            int best_length = 0, best_disp = 0;
+            for (int disp = 2; disp <= 4096 && disp <= pos; disp++) {
+                int length = 0;
+                while (length < 18 && pos + length < size && data[pos + length] == data[pos - disp + length]) {
+                    length++;
+                }
+                if (length > best_length) {
+                    best_length = length;
+                    best_disp = disp;
+                }
+            }
+
+            if (best_length >= 3) {
+                flags |= 1 << bit;
+                blob_byte(out, ((best_length - 3) << 4) | ((best_disp - 1) >> 8));
+                blob_byte(out, (best_disp - 1) & 0xff);
+                pos += best_length;
+            } else {
+                blob_byte(out, data[pos++]);
+            }
+        }
+
+        out->data[flags_at] = flags;
+    }
+    blob_align(out);
+}
+
+void pack_rle(struct Blob* out, const unsigned char* data, int size) {
+    blob_init(out, size + size / 128 + 8);
+    blob_header(out, CODEC_RLE, size);
+
+    int pos = 0;
+    while (pos < size) {
+        int run = 1;
+        while (run < 130 && pos + run < size && data[pos + run] == data[pos]) {
+            run++;
+        }
+
+        if (run >= 3) {
+            blob_byte(out, 0x80 | (run - 3));
+            blob_byte(out, data[pos]);
+            pos += run;
+            continue;
+        }
+
+        int start = pos;
+        while (pos < size && pos - start < 128) {
+            if (pos + 2 < size && data[pos] == data[pos + 1] && data[pos] == data[pos + 2]) {
+                break;
+            }
+            pos++;
+        }
+        blob_byte(out, (pos - start) - 1);
+        for (int i = start; i < pos; i++) {
+            blob_byte(out, data[i]);
+        }
+    }
+    blob_align(out);
+}
+
+struct HuffNode {
+    int count;
+    int symbol;
+    int child[2];
+};
+
+/* 8-bit Huffman with the BIOS tree layout; returns 0 if a child offset overflows 6 bits */
+int pack_huffman(struct Blob* out, const unsigned char* data, int size) {
+    struct HuffNode nodes[512];
+    int live[256], live_count = 0, node_count = 0;
+
+    int counts[256] = {0};
+    for (int i = 0; i < size; i++) {
+        counts[data[i]]++;
+    }
+    for (int s = 0; s < 256; s++) {
+        if (counts[s]) {
+            nodes[node_count] = (struct HuffNode) {counts[s], s, {-1, -1}};
+            live[live_count++] = node_count++;
+        }
+    }
+    if (live_count == 1) {
+        int other = data[0] ^ 1;
+        nodes[node_count] = (struct HuffNode) {0, other, {-1, -1}};
+        live[live_count++] = node_count++;
+    }
+
+    while (live_count > 1) {
+        for (int pick = 0; pick < 2; pick++) {
+            for (int i = live_count - 1; i > 0; i--) {
+                if (nodes[live[i]].count < nodes[live[i - 1]].count) {
+                    int t = live[i]; live[i] = live[i - 1]; live[i - 1] = t;
+                }
+            }
+        }
+        int a = live[0], b = live[1];
+        nodes[node_count] = (struct HuffNode) {nodes[a].count + nodes[b].count, -1, {a, b}};
+        live[0] = node_count++;
+        live[1] = live[--live_count];
+    }
+    int root = live[0];
+
+    /* table index 0 is the tree size byte and the root sits at 1, children go in pairs */
+    unsigned char table[512];
+    int queue[512], index_of[512], head = 0, tail = 0, next_pair = 2;
+    queue[tail++] = root;
+    index_of[root] = 1;
+    table[1] = 0;
+
+    while (head < tail) {
+        int node = queue[head++];
+        if (nodes[node].symbol >= 0) {
+            table[index_of[node]] = nodes[node].symbol;
+            continue;
+        }
+
+        int at = index_of[node];
+        int offset = (next_pair - (at & ~1) - 2) / 2;
+        if (offset > 63) {
+            return 0;
+        }
+        unsigned char entry = offset;
+        for (int side = 0; side < 2; side++) {
+            int child = nodes[node].child[side];
+            index_of[child] = next_pair + side;
+            if (nodes[child].symbol >= 0) {
+                entry |= side ? 0x40 : 0x80;
+            }
+            queue[tail++] = child;
+        }
+        table[at] = entry;
+        next_pair += 2;
+    }
+
+    int table_size = next_pair;
+    while (table_size & 3) {
+        table[table_size++] = 0;
+    }
+    table[0] = table_size / 2 - 1;
+
+    unsigned int codes[256];
+    int lengths[256];
+    for (int n = 0; n < node_count; n++) {
+        if (nodes[n].symbol < 0) {
+            continue;
+        }
+        unsigned int code = 0;
+        int length = 0;
+        for (int at = n; at != root; length++) {
+            int parent = 0;
+            while (nodes[parent].symbol >= 0 || (nodes[parent].child[0] != at && nodes[parent].child[1] != at)) {
+                parent++;
+            }
+            code |= (nodes[parent].child[1] == at) << length;
+            at = parent;
+        }
+        codes[nodes[n].symbol] = code;
+        lengths[nodes[n].symbol] = length;
+    }
+
+    blob_init(out, size * 2 + table_size + 8);
+    blob_header(out, CODEC_HUFFMAN | 8, size);
+    for (int i = 0; i < table_size; i++) {
+        blob_byte(out, table[i]);
+    }
+
+    unsigned int word = 0;
+    int bits = 0;
+    for (int i = 0; i < size; i++) {
+        for (int b = lengths[data[i]] - 1; b >= 0; b--) {
+            word |= ((codes[data[i]] >> b) & 1) << (31 - bits);
+            if (++bits == 32) {
+                blob_byte(out, word);
+                blob_byte(out, word >> 8);
+                blob_byte(out, word >> 16);
+                blob_byte(out, word >> 24);
+                word = 0;
+                bits = 0;
+            }
+        }
+    }
+    if (bits) {
+        blob_byte(out, word);
+        blob_byte(out, word >> 8);
+        blob_byte(out, word >> 16);
+        blob_byte(out, word >> 24);
+    }
+    return 1;
+}
+
+const char* codec_name(int codec) {
+    switch (codec & 0xf0) {
+        case CODEC_LZ77: return "lz77";
+        case CODEC_HUFFMAN: return "huffman";
+        case CODEC_RLE: return "rle";
+        default: return "raw";
+    }
+}
+
+int total_raw = 0, total_packed = 0;
+
+void emit(const char* name, const void* source, int size) {
+    const unsigned char* data = source;
+    struct Blob candidates[4];
+    int count = 0;
+
+    pack_raw(&candidates[count++], data, size);
+    pack_lz77(&candidates[count++], data, size);
+    pack_rle(&candidates[count++], data, size);
+    if (pack_huffman(&candidates[count], data, size)) {
+        count++;
+    }
+
+    struct Blob* best = &candidates[0];
+    for (int i = 1; i < count; i++) {
+        if (candidates[i].size < best->size) {
+            best = &candidates[i];
+        }
+    }
+
+    fprintf(stderr, "%-20s %6d bytes ->", name, size);
+    for (int i = 0; i < count; i++) {
+        fprintf(stderr, " %s %d%s", codec_name(candidates[i].data[0]), candidates[i].size, &candidates[i] == best ? "*" : "");
+    }
+    fprintf(stderr, "\n");
+    total_raw += size;
+    total_packed += best->size;
+
+    printf("/* %s: %d -> %d bytes (%s) */\n", name, size, best->size, codec_name(best->data[0]));
+    printf("#define %s_size %d\n\n", name, size);
+    printf("const unsigned char %s_packed [] __attribute__((aligned(4))) = {", name);
+    for (int i = 0; i < best->size; i++) {
+        printf("%s0x%02x,", i % 12 ? " " : "\n    ", best->data[i]);
+    }
+    printf("\n};\n\n");
+
+    for (int i = 0; i < count; i++) {
+        free(candidates[i].data);
+    }
+}
+
+int log2_exact(int n) {
+    int shift = 0;
+    while ((1 << shift) < n) {
+        shift++;
+    }
+    return (1 << shift) == n ? shift : -1;
+}
+
+#define MAX_BANKS 16
+
+/* 4bpp tiles with their palette banks, built from png2gba 8bpp tiles */
+struct Banked {
+    unsigned char* tiles;
+    int tile_count;
+    unsigned char* tile_bank;
+    unsigned short palette[MAX_BANKS * 16];
+    int banks;
+};
+
+/* gives each tile the first bank that has room for the colors it adds, slot 0 of every bank stays transparent */
+void bank_tiles(struct Banked* banked, const unsigned char* data, int size, const unsigned short* palette) {
+    int slot[MAX_BANKS][256];
+    int used[MAX_BANKS];
+
+    banked->tile_count = size / 64;
+    banked->tiles = calloc(size / 2, 1);
+    banked->tile_bank = calloc(banked->tile_count, 1);
+    banked->banks = 0;
+    memset(banked->palette, 0, sizeof(banked->palette));
+
+    for (int t = 0; t < banked->tile_count; t++) {
+        const unsigned char* tile = data + t * 64;
+
+        int bank;
+        for (bank = 0; bank < MAX_BANKS; bank++) {
+            if (bank == banked->banks) {
+                for (int c = 0; c < 256; c++) {
+                    slot[bank][c] = -1;
+                }
+                slot[bank][0] = 0;
+                used[bank] = 1;
+                banked->palette[bank * 16] = palette[0];
+            }
+
+            int added = 0;
+            int seen[256] = {0};
+            for (int i = 0; i < 64; i++) {
+                if (slot[bank][tile[i]] < 0 && !seen[tile[i]]) {
+                    seen[tile[i]] = 1;
+                    added++;
+                }
+            }
+            if (used[bank] + added <= 16) {
+                break;
+            }
+        }
+        if (bank == MAX_BANKS) {
+            fprintf(stderr, "tile %d does not fit any of the %d palette banks\n", t, MAX_BANKS);
+            exit(1);
+        }
+        if (bank == banked->banks) {
+            banked->banks++;
+        }
+
+        banked->tile_bank[t] = bank;
+        for (int i = 0; i < 64; i++) {
+            int color = tile[i];
+            if (slot[bank][color] < 0) {
+                slot[bank][color] = used[bank]++;
+                banked->palette[bank * 16 + slot[bank][color]] = palette[color];
+            }
+            banked->tiles[t * 32 + i / 2] |= slot[bank][color] << ((i & 1) * 4);
+        }
+    }
+}
+
+/* the same colors with red and blue exchanged */
+void swap_bank(unsigned short* dest, const unsigned short* source) {
+    for (int i = 0; i < 16; i++) {
+        unsigned short color = source[i];
+        dest[i] = ((color & 0x1f) << 10) | (color & 0x3e0) | ((color >> 10) & 0x1f);
+    }
+}
+
+/* a 4bpp tile mirrored left-right (flip & 1) and top-bottom (flip & 2) */
+void flip_tile(unsigned char* dest, const unsigned char* source, int flip) {
+    for (int y = 0; y < 8; y++) {
+        int sy = flip & 2 ? 7 - y : y;
+        for (int x = 0; x < 8; x++) {
+            int sx = flip & 1 ? 7 - x : x;
+            int pixel = (source[sy * 4 + sx / 2] >> ((sx & 1) * 4)) & 15;
+            if (x & 1) {
+                dest[y * 4 + x / 2] |= pixel << 4;
+            } else {
+                dest[y * 4 + x / 2] = pixel;
+            }
+        }
+    }
+}
+
+/* keeps the first copy of every tile, matching any of its flips, and builds remap:
+ * original tile -> kept tile | flip bits | palette bank, as a map entry would hold them */
+void dedupe_tiles(struct Banked* banked, unsigned short* remap) {
+    int kept = 0, flipped = 0;
+    for (int t = 0; t < banked->tile_count; t++) {
+        const unsigned char* tile = banked->tiles + t * 32;
+        int match = -1, flip;
+        for (flip = 0; flip < 4 && match < 0; flip++) {
+            unsigned char variant[32];
+            flip_tile(variant, tile, flip);
+            for (int k = 0; k < kept; k++) {
+                if (memcmp(banked->tiles + k * 32, variant, 32) == 0) {
+                    match = k;
+                    break;
+                }
+            }
+        }
+        flip--;
+
+        if (match < 0) {
+            memmove(banked->tiles + kept * 32, tile, 32);
+            match = kept++;
+            flip = 0;
+        } else if (flip) {
+            flipped++;
+        }
+        remap[t] = match | (flip << 10) | (banked->tile_bank[t] << 12);
+    }
+
+    fprintf(stderr, "%-20s %6d tiles -> %d tiles (%d flipped), %d bytes saved\n",
+        "tile dedupe", banked->tile_count, kept, flipped, (banked->tile_count - kept) * 32);
+    printf("/* tile dedupe: %d tiles -> %d tiles (%d flipped), %d bytes saved */\n",
+        banked->tile_count, kept, flipped, (banked->tile_count - kept) * 32);
+    banked->tile_count = kept;
+}
+
+/* the index macro wraps both coordinates, so the width must be a power of two; levels scroll
+ * sideways only and collision_columns keeps one 32-bit word per column, so the height is one
+ * screen block */
+void emit_map_layout(const char* name, int width, int height) {
+    int shift = log2_exact(width);
+    if (shift < 5 || height != 32) {
+        fprintf(stderr, "%s: %dx%d is not a power-of-two number of screen blocks in a row\n", name, width, height);
+        exit(1);
+    }
+
+    printf("#define %s_width %d\n", name, width);
+    printf("#define %s_height %d\n", name, height);
+    printf("#define %s_width_shift %d\n", name, shift);
+    printf("#define %s_index(tx, ty) ((((ty) & %d) << %d) | ((tx) & %d))\n\n", name, height - 1, shift, width - 1);
+}
+
+/* the map as stored, one 32x32 screen block after another with the deduped tiles, for loading
+ * straight into VRAM, and the original tile ids row-major for gameplay lookups, which stream
+ * into VRAM through name_remap; flips already in the source combine with those of the remap */
+void emit_map(const char* name, const unsigned short* source, int width, int height, const unsigned short* remap) {
+    int count = width * height;
+    unsigned short* blocks = malloc(count * sizeof(unsigned short));
+    for (int i = 0; i < count; i++) {
+        blocks[i] = remap[source[i] & 0x3ff] ^ (source[i] & 0x0c00);
+    }
+
+    unsigned short* linear = malloc(count * sizeof(unsigned short));
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int block = (y >> 5) * (width >> 5) + (x >> 5);
+            linear[y * width + x] = source[block * 1024 + (y & 31) * 32 + (x & 31)] & 0x0fff;
+        }
+    }
+
+    emit(name, blocks, count * sizeof(unsigned short));
+
+    char linear_name[64];
+    snprintf(linear_name, sizeof(linear_name), "%s_linear", name);
+    if (memcmp(linear, blocks, count * sizeof(unsigned short)) == 0) {
+        printf("/* both layouts of %s are the same */\n", name);
+        printf("#define %s_size %s_size\n", linear_name, name);
+        printf("#define %s_packed %s_packed\n\n", linear_name, name);
+    } else {
+        emit(linear_name, linear, count * sizeof(unsigned short));
+    }
+    free(linear);
+    free(blocks);
+}
+
+/* small and read at random while streaming columns, so it stays unpacked */
+void emit_remap(const char* name, const unsigned short* remap, int count) {
+    printf("#define %s_tiles %d\n", name, count);
+    printf("const unsigned short %s_remap [] = {", name);
+    for (int i = 0; i < count; i++) {
+        printf("%s0x%04x,", i % 8 ? " " : "\n    ", remap[i]);
+    }
+    printf("\n};\n\n");
+}
+
+int main() {
+    printf("/* assets.h\n * generated by tools/assets.c from background.h, link.h, map.h and map2.h */\n\n");
+
+    printf("#define background_width %d\n", background_width);
+    printf("#define background_height %d\n", background_height);
+    printf("#define link_width %d\n", link_width);
+    printf("#define link_height %d\n", link_height);
+    printf("\n");
+    emit_map_layout("map", map_width, map_height);
+    emit_map_layout("map2", map2_width, map2_height);
+
+    struct Banked background;
+    bank_tiles(&background, background_data, sizeof(background_data), background_palette);
+
+    /* link gets one bank, the enemy the same tiles with a swapped copy of it */
+    struct Banked link;
+    bank_tiles(&link, link_data, sizeof(link_data), link_palette);
+    if (link.banks != 1) {
+        fprintf(stderr, "link_data needs %d palette banks, the palette swap expects 1\n", link.banks);
+        exit(1);
+    }
+    swap_bank(link.palette + 16, link.palette);
+
+    printf("#define background_banks %d\n", background.banks);
+    printf("#define link_bank 0\n");
+    printf("#define link_swap_bank 1\n\n");
+
+    int background_tiles = background.tile_count;
+    unsigned short* background_remap = malloc(background_tiles * sizeof(unsigned short));
+    dedupe_tiles(&background, background_remap);
+    printf("\n");
+    emit_remap("background", background_remap, background_tiles);
+
+    emit("background_data", background.tiles, background.tile_count * 32);
+    emit("background_palette", background.palette, background.banks * 32);
+    emit("link_data", link.tiles, link.tile_count * 32);
+    emit("link_palette", link.palette, 2 * 32);
+    emit_map("map", map, map_width, map_height, background_remap);
+    emit_map("map2", map2, map2_width, map2_height, background_remap);
+
+    fprintf(stderr, "%-20s %6d bytes -> %d bytes\n", "total", total_raw, total_packed);
+    return 0;
+}
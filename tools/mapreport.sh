@@ -0,0 +1,38 @@
+#!/bin/sh
+# mapreport.sh
+# lists what landed in ROM, IWRAM and EWRAM for a linked game.elf and how much
+# IWRAM is left above the stack reserve
+#
+#     tools/mapreport.sh game.elf
+
+elf=${1:-game.elf}
+nm=${NM:-arm-none-eabi-nm}
+
+$nm -S -n --radix=d "$elf" | awk '
+function region(address) {
+    if (address >= 134217728) return "rom";
+    if (address >= 50331648 && address < 50364416) return "iwram";
+    if (address >= 33554432 && address < 33816576) return "ewram";
+    return "";
+}
+
+NF == 3 && $3 == "__bss_end" { bss_end = $1 + 0 }
+NF == 3 && $3 == "__sp_usr" { sp_usr = $1 + 0 }
+NF == 3 && $3 == "__stack_reserve" { reserve = $1 + 0 }
+
+NF == 4 {
+    r = region($1 + 0);
+    if (r == "") next;
+    total[r] += $2;
+    if (r != "rom" || $2 >= 1024) {
+        printf "%-6s 0x%08x %7d %s\n", r, $1, $2, $4;
+    }
+}
+
+END {
+    printf "\n";
+    printf "rom    %7d bytes in symbols\n", total["rom"];
+    printf "ewram  %7d bytes of 262144\n", total["ewram"];
+    printf "iwram  %7d bytes in symbols, %d bytes used up to __bss_end\n", total["iwram"], bss_end - 50331648;
+    printf "iwram  %7d bytes free below the %d byte stack reserve\n", sp_usr - reserve - bss_end, reserve;
+}'
@@ -0,0 +1,71 @@
+/* profdump.c
+ * decodes the profiler windows in a save file into CSV
+ *
+ *     gcc -O2 -o profdump tools/profdump.c && ./profdump game.sav > profile.csv
+ */
+
+#include <stdio.h>
+
+/* must match the PROFILE_* layout in main.c */
+#define PROFILE_SRAM 0x6000
+#define PROFILE_MAGIC 0x464f5250
+#define PROFILE_NAME_SIZE 8
+#define PROFILE_MAX_ZONES 16
+#define PROFILE_RECORDS (PROFILE_SRAM + 12 + PROFILE_MAX_ZONES * PROFILE_NAME_SIZE)
+#define SRAM_SIZE 0x8000
+
+unsigned char sram[SRAM_SIZE];
+
+unsigned int read16(int offset) {
+    return sram[offset] | (sram[offset + 1] << 8);
+}
+
+unsigned int read32(int offset) {
+    return read16(offset) | (read16(offset + 2) << 16);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s game.sav\n", argv[0]);
+        return 1;
+    }
+
+    FILE* file = fopen(argv[1], "rb");
+    if (!file) {
+        perror(argv[1]);
+        return 1;
+    }
+    fread(sram, 1, SRAM_SIZE, file);
+    fclose(file);
+
+    if (read32(PROFILE_SRAM) != PROFILE_MAGIC) {
+        fprintf(stderr, "%s: no profiler data\n", argv[1]);
+        return 1;
+    }
+
+    int zones = read16(PROFILE_SRAM + 4);
+    int window = read16(PROFILE_SRAM + 6);
+    unsigned int written = read32(PROFILE_SRAM + 8);
+    int record_size = 4 + zones * 12;
+    unsigned int capacity = (SRAM_SIZE - PROFILE_RECORDS) / record_size;
+
+    char names[PROFILE_MAX_ZONES][PROFILE_NAME_SIZE + 1];
+    for (int z = 0; z < zones; z++) {
+        for (int c = 0; c < PROFILE_NAME_SIZE; c++) {
+            names[z][c] = sram[PROFILE_SRAM + 12 + z * PROFILE_NAME_SIZE + c];
+        }
+        names[z][PROFILE_NAME_SIZE] = 0;
+    }
+
+    printf("window,first_frame,zone,min,avg,max\n");
+    unsigned int first = written > capacity ? written - capacity : 0;
+    for (unsigned int w = first; w < written; w++) {
+        int record = PROFILE_RECORDS + (w % capacity) * record_size;
+        unsigned int index = read32(record);
+        for (int z = 0; z < zones; z++) {
+            printf("%u,%u,%s,%u,%u,%u\n", index, index * window, names[z],
+                read32(record + 4 + z * 12), read32(record + 8 + z * 12), read32(record + 12 + z * 12));
+        }
+    }
+    return 0;
+}